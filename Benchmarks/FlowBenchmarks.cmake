@@ -6,10 +6,22 @@ get_filename_component(FlowBenchmarksDir ${CMAKE_CURRENT_LIST_FILE} PATH)
 
 set(FlowBenchmarksSources
     ${FlowBenchmarksDir}/Main.cpp
+    ${FlowBenchmarksDir}/benchmarks_Scenarios.cpp
+    ${FlowBenchmarksDir}/benchmarks_Scheduler.cpp
 )
 
+# taskflow baseline, only available when the submodule is checked out
+set(FlowBenchmarksTaskflowDir ${FlowBenchmarksDir}/../External/taskflow)
+if(EXISTS ${FlowBenchmarksTaskflowDir}/taskflow/taskflow.hpp)
+    list(APPEND FlowBenchmarksSources ${FlowBenchmarksDir}/benchmarks_Taskflow.cpp)
+endif()
+
 add_executable(${PROJECT_NAME} ${FlowBenchmarksSources})
 
+if(EXISTS ${FlowBenchmarksTaskflowDir}/taskflow/taskflow.hpp)
+    target_include_directories(${PROJECT_NAME} PRIVATE ${FlowBenchmarksTaskflowDir})
+endif()
+
 target_link_libraries(${PROJECT_NAME}
 PUBLIC
     Flow
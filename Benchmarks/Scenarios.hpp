@@ -0,0 +1,162 @@
+/**
+ * @ Author: Matthieu Moinvaziri
+ * @ Description: Graph scenarios shared by Flow and taskflow benchmarks
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+/**
+ * @brief Topologies benchmarked side by side on Flow and taskflow
+ *  Builders only use 'emplace' on the graph and 'precede' on tasks, so the same code builds both graph types
+ *  Each builder returns the number of nodes executed per run
+ */
+namespace Scenarios
+{
+    constexpr std::size_t ChainLength { 256ul };
+    constexpr std::size_t FanOutWidth { 256ul };
+    constexpr std::size_t TreeDepth { 8ul }; // 255 nodes
+    constexpr std::size_t RandomDagSize { 512ul };
+    constexpr std::size_t RandomDagMaxPredecessors { 4ul };
+    constexpr std::size_t RandomDagWindow { 64ul }; // Predecessors are picked among the previous nodes of this window
+    constexpr std::size_t SwitchTreeCount { 8ul };
+    constexpr std::size_t SwitchTreeDepth { 6ul }; // Each run executes one path of 6 switch nodes and a leaf per tree
+    constexpr std::size_t NestedCount { 16ul }; // Number of nested graphs / dynamic nodes
+    constexpr std::size_t NestedSize { 16ul }; // Chain length of each nested graph / dynamic node
+    constexpr std::size_t RepeatCount { 16ul }; // Runs per iteration of repeat loops
+    constexpr std::uint32_t RandomSeed { 42u };
+
+    /** @brief Busy work of a node, 'granularity' is its loop count */
+    inline void Spin(const std::int64_t granularity) noexcept
+    {
+        auto x = 0ll;
+        for (auto i = 0ll; i < granularity; ++i)
+            benchmark::DoNotOptimize(x += i);
+    }
+
+    /** @brief Sweep worker counts and task granularities */
+    inline void SweepWorkers(benchmark::internal::Benchmark *benchmark)
+    {
+        benchmark->ArgNames({ "workers", "granularity" })
+            ->ArgsProduct({ { 1, 2, 4, 8 }, { 0, 256, 4096 } })
+            ->UseRealTime();
+    }
+
+    /** @brief Sweep graph sizes of construction benchmarks */
+    inline void SweepSizes(benchmark::internal::Benchmark *benchmark)
+    {
+        benchmark->ArgNames({ "nodes" })->RangeMultiplier(4)->Range(256, 16384);
+    }
+
+    /** @brief Deterministic edges of a random DAG, each edge goes from a lower to a higher node index */
+    [[nodiscard]] inline std::vector<std::pair<std::size_t, std::size_t>> RandomDagEdges(const std::size_t size)
+    {
+        std::vector<std::pair<std::size_t, std::size_t>> edges;
+        std::mt19937 engine(RandomSeed);
+
+        for (auto to = 1ul; to < size; ++to) {
+            const auto first = to > RandomDagWindow ? to - RandomDagWindow : 0ul;
+            std::uniform_int_distribution<std::size_t> pick(first, to - 1ul);
+            const auto count = std::uniform_int_distribution<std::size_t>(1ul, RandomDagMaxPredecessors)(engine);
+            const auto begin = edges.size();
+            for (auto i = 0ul; i < count; ++i) {
+                const auto from = pick(engine);
+                bool duplicate = false;
+                for (auto j = begin; j < edges.size(); ++j)
+                    duplicate |= edges[j].first == from;
+                if (!duplicate)
+                    edges.emplace_back(from, to);
+            }
+        }
+        return edges;
+    }
+
+    /** @brief Chain of nodes */
+    template<typename GraphType, typename Work>
+    std::size_t BuildChain(GraphType &graph, const Work &work, const std::size_t length = ChainLength)
+    {
+        auto previous = graph.emplace(work);
+        for (auto i = 1ul; i < length; ++i) {
+            auto task = graph.emplace(work);
+            previous.precede(task);
+            previous = task;
+        }
+        return length;
+    }
+
+    /** @brief Source node followed by independent leaves joined into a sink node */
+    template<typename GraphType, typename Work>
+    std::size_t BuildFanOutFanIn(GraphType &graph, const Work &work)
+    {
+        auto source = graph.emplace(work);
+        auto sink = graph.emplace(work);
+        for (auto i = 0ul; i < FanOutWidth; ++i) {
+            auto leaf = graph.emplace(work);
+            source.precede(leaf);
+            leaf.precede(sink);
+        }
+        return FanOutWidth + 2ul;
+    }
+
+    /** @brief Complete binary tree, each node precedes its two children */
+    template<typename GraphType, typename Work>
+    std::size_t BuildBinaryTree(GraphType &graph, const Work &work)
+    {
+        std::vector<decltype(graph.emplace(work))> tasks;
+        const auto count = (1ul << TreeDepth) - 1ul;
+
+        tasks.reserve(count);
+        for (auto i = 0ul; i < count; ++i) {
+            tasks.push_back(graph.emplace(work));
+            if (i)
+                tasks[(i - 1ul) / 2ul].precede(tasks[i]);
+        }
+        return count;
+    }
+
+    /** @brief Random DAG of 'size' nodes */
+    template<typename GraphType, typename Work>
+    std::size_t BuildRandomDag(GraphType &graph, const Work &work, const std::vector<std::pair<std::size_t, std::size_t>> &edges, const std::size_t size = RandomDagSize)
+    {
+        std::vector<decltype(graph.emplace(work))> tasks;
+
+        tasks.reserve(size);
+        for (auto i = 0ul; i < size; ++i)
+            tasks.push_back(graph.emplace(work));
+        for (const auto &edge : edges)
+            tasks[edge.first].precede(tasks[edge.second]);
+        return size;
+    }
+
+    /** @brief Independent decision trees of switch nodes, each switch node alternates between its two children on every run */
+    template<typename GraphType, typename Work>
+    std::size_t BuildSwitchTrees(GraphType &graph, const Work &work, const std::int64_t granularity)
+    {
+        const auto makeSwitch = [&graph, granularity] {
+            return graph.emplace([granularity, count = 0u]() mutable -> int {
+                Spin(granularity);
+                return static_cast<int>(count++ & 1u);
+            });
+        };
+        const auto build = [&](const auto &self, const std::size_t depth) -> decltype(graph.emplace(work)) {
+            if (depth == SwitchTreeDepth)
+                return graph.emplace(work);
+            auto node = makeSwitch();
+            auto left = self(self, depth + 1ul);
+            auto right = self(self, depth + 1ul);
+            node.precede(left);
+            node.precede(right);
+            return node;
+        };
+
+        for (auto i = 0ul; i < SwitchTreeCount; ++i)
+            build(build, 0ul);
+        return SwitchTreeCount * (SwitchTreeDepth + 1ul);
+    }
+}
@@ -0,0 +1,166 @@
+/**
+ * @ Author: Matthieu Moinvaziri
+ * @ Description: Flow scenario benchmarks, see benchmarks_Taskflow.cpp for their taskflow equivalents
+ */
+
+#include <Flow/Scheduler.hpp>
+
+#include "Scenarios.hpp"
+
+/** @brief Schedule a graph on every iteration
+ *  Arguments: worker count, task granularity
+ *  The builder returns the number of nodes executed per run */
+template<typename Builder>
+static void RunScenario(benchmark::State &state, const Builder &builder)
+{
+    Flow::Scheduler scheduler(static_cast<std::size_t>(state.range(0)));
+    Flow::Graph graph;
+    const auto granularity = state.range(1);
+
+    const auto nodeCount = builder(graph, [granularity] { Scenarios::Spin(granularity); }, granularity);
+    for (auto _ : state) {
+        scheduler.schedule(graph);
+        graph.wait();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(nodeCount));
+}
+
+static void FlowLinearChain(benchmark::State &state)
+{
+    RunScenario(state, [](auto &graph, const auto &work, auto) { return Scenarios::BuildChain(graph, work); });
+}
+
+BENCHMARK(FlowLinearChain)->Name("LinearChain/Flow")->Apply(Scenarios::SweepWorkers);
+
+/** @brief Linear chain fused into a single scheduled unit */
+static void FlowLinearChainFused(benchmark::State &state)
+{
+    RunScenario(state, [](auto &graph, const auto &work, auto) {
+        graph.setChainFusion(true);
+        return Scenarios::BuildChain(graph, work);
+    });
+}
+
+BENCHMARK(FlowLinearChainFused)->Name("LinearChain/FlowFused")->Apply(Scenarios::SweepWorkers);
+
+static void FlowFanOutFanIn(benchmark::State &state)
+{
+    RunScenario(state, [](auto &graph, const auto &work, auto) { return Scenarios::BuildFanOutFanIn(graph, work); });
+}
+
+BENCHMARK(FlowFanOutFanIn)->Name("FanOutFanIn/Flow")->Apply(Scenarios::SweepWorkers);
+
+static void FlowBinaryTree(benchmark::State &state)
+{
+    RunScenario(state, [](auto &graph, const auto &work, auto) { return Scenarios::BuildBinaryTree(graph, work); });
+}
+
+BENCHMARK(FlowBinaryTree)->Name("BinaryTree/Flow")->Apply(Scenarios::SweepWorkers);
+
+static void FlowRandomDag(benchmark::State &state)
+{
+    const auto edges = Scenarios::RandomDagEdges(Scenarios::RandomDagSize);
+
+    RunScenario(state, [&edges](auto &graph, const auto &work, auto) { return Scenarios::BuildRandomDag(graph, work, edges); });
+}
+
+BENCHMARK(FlowRandomDag)->Name("RandomDag/Flow")->Apply(Scenarios::SweepWorkers);
+
+static void FlowSwitchTrees(benchmark::State &state)
+{
+    RunScenario(state, [](auto &graph, const auto &work, const auto granularity) { return Scenarios::BuildSwitchTrees(graph, work, granularity); });
+}
+
+BENCHMARK(FlowSwitchTrees)->Name("SwitchTrees/Flow")->Apply(Scenarios::SweepWorkers);
+
+/** @brief Source node followed by independent Graph nodes, each one a chain */
+static void FlowNestedGraphs(benchmark::State &state)
+{
+    std::vector<Flow::Graph> subGraphs(Scenarios::NestedCount); // Never resized, graph nodes reference their graph
+
+    RunScenario(state, [&subGraphs](auto &graph, const auto &work, auto) {
+        auto source = graph.emplace(work);
+        for (auto &subGraph : subGraphs) {
+            Scenarios::BuildChain(subGraph, work, Scenarios::NestedSize);
+            auto node = graph.emplace(subGraph);
+            source.precede(node);
+        }
+        return 1ul + Scenarios::NestedCount * Scenarios::NestedSize;
+    });
+}
+
+BENCHMARK(FlowNestedGraphs)->Name("NestedGraphs/Flow")->Apply(Scenarios::SweepWorkers);
+
+/** @brief Source node followed by independent Dynamic nodes, each one building a chain on every run */
+static void FlowDynamicNodes(benchmark::State &state)
+{
+    RunScenario(state, [](auto &graph, const auto &work, auto) {
+        auto source = graph.emplace(work);
+        for (auto i = 0ul; i < Scenarios::NestedCount; ++i) {
+            auto node = graph.emplace([work](Flow::Graph &subGraph) {
+                subGraph.clear();
+                Scenarios::BuildChain(subGraph, work, Scenarios::NestedSize);
+            });
+            source.precede(node);
+        }
+        return 1ul + Scenarios::NestedCount * (Scenarios::NestedSize + 1ul);
+    });
+}
+
+BENCHMARK(FlowDynamicNodes)->Name("DynamicNodes/Flow")->Apply(Scenarios::SweepWorkers);
+
+/** @brief Fan-out / fan-in graph repeated by its repeat callback */
+static void FlowRepeatLoop(benchmark::State &state)
+{
+    Flow::Scheduler scheduler(static_cast<std::size_t>(state.range(0)));
+    Flow::Graph graph;
+    const auto granularity = state.range(1);
+    auto runs = 0ul;
+
+    Scenarios::BuildFanOutFanIn(graph, [granularity] { Scenarios::Spin(granularity); });
+    graph.setRepeatCallback([&runs] { return ++runs < Scenarios::RepeatCount; });
+    for (auto _ : state) {
+        runs = 0ul;
+        scheduler.schedule(graph);
+        graph.wait();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(graph.size() * Scenarios::RepeatCount));
+}
+
+BENCHMARK(FlowRepeatLoop)->Name("RepeatLoop/Flow")->Apply(Scenarios::SweepWorkers);
+
+/** @brief Construction of a random DAG
+ *  Arguments: node count */
+static void FlowConstruction(benchmark::State &state)
+{
+    const auto size = static_cast<std::size_t>(state.range(0));
+    const auto edges = Scenarios::RandomDagEdges(size);
+
+    for (auto _ : state) {
+        Flow::Graph graph;
+        Scenarios::BuildRandomDag(graph, Flow::EmptyWork, edges, size);
+        benchmark::DoNotOptimize(graph.size());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(size));
+}
+
+BENCHMARK(FlowConstruction)->Name("Construction/Flow")->Apply(Scenarios::SweepSizes);
+
+/** @brief Preprocess of a random DAG
+ *  Arguments: node count */
+static void FlowPreprocess(benchmark::State &state)
+{
+    const auto size = static_cast<std::size_t>(state.range(0));
+    Flow::Graph graph;
+
+    Scenarios::BuildRandomDag(graph, Flow::EmptyWork, Scenarios::RandomDagEdges(size), size);
+    Flow::Task first(graph.begin()->node());
+    for (auto _ : state) {
+        // Resetting an automatic priority is a public mutation that requires a new preprocess
+        first.setPriority(Flow::Priority::Auto);
+        graph.preprocess();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(size));
+}
+
+BENCHMARK(FlowPreprocess)->Name("Preprocess/Flow")->Apply(Scenarios::SweepSizes);
@@ -0,0 +1,172 @@
+/**
+ * @ Author: Matthieu Moinvaziri
+ * @ Description: Scheduler benchmarks
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <Flow/StaticGraph.hpp>
+
+/** @brief Source node followed by 'width' independent leaves joined into a sink node
+ *  Arguments: worker count, graph width, steal half policy */
+static void WideFanOut(benchmark::State &state)
+{
+    Flow::Scheduler scheduler(static_cast<std::size_t>(state.range(0)), Flow::Scheduler::StealPolicy { .stealHalf = state.range(2) != 0 });
+    Flow::Graph graph;
+    const auto width = state.range(1);
+    auto source = graph.emplace(Flow::EmptyWork);
+    auto sink = graph.emplace(Flow::EmptyWork);
+
+    for (auto i = 0; i < width; ++i) {
+        auto leaf = graph.emplace([] {
+            auto x = 0u;
+            for (auto j = 0u; j < 256u; ++j)
+                benchmark::DoNotOptimize(x += j);
+        });
+        source.precede(leaf);
+        leaf.precede(sink);
+    }
+    for (auto _ : state) {
+        scheduler.schedule(graph);
+        graph.wait();
+    }
+    state.SetItemsProcessed(state.iterations() * (width + 2));
+}
+
+BENCHMARK(WideFanOut)
+    ->ArgNames({ "workers", "width", "stealHalf" })
+    ->ArgsProduct({ { 1, 2, 4, 8, 16, 32 }, { 256, 4096 }, { 0, 1 } })
+    ->UseRealTime();
+
+/** @brief Chain of 'length' small tasks fanning out to 'width' leaves at each step, scheduled repeatedly
+ *  Arguments: worker count, compilation (0: none, 1: dynamic schedule, 2: static schedule) */
+static void RepeatedGraph(benchmark::State &state)
+{
+    constexpr auto Length = 64;
+    constexpr auto Width = 16;
+    Flow::Scheduler scheduler(static_cast<std::size_t>(state.range(0)));
+    Flow::Graph graph;
+    auto work = [] {
+        auto x = 0u;
+        for (auto j = 0u; j < 64u; ++j)
+            benchmark::DoNotOptimize(x += j);
+    };
+    auto previous = graph.emplace(work);
+
+    for (auto i = 0; i < Length; ++i) {
+        auto join = graph.emplace(work);
+        for (auto j = 0; j < Width; ++j) {
+            auto leaf = graph.emplace(work);
+            previous.precede(leaf);
+            leaf.precede(join);
+        }
+        previous = join;
+    }
+    if (state.range(1))
+        graph.compile(state.range(1) == 2 ? Flow::ScheduleMode::Static : Flow::ScheduleMode::Dynamic);
+    for (auto _ : state) {
+        scheduler.schedule(graph);
+        graph.wait();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(graph.size()));
+}
+
+BENCHMARK(RepeatedGraph)
+    ->ArgNames({ "workers", "compiled" })
+    ->ArgsProduct({ { 1, 2, 4, 8 }, { 0, 1, 2 } })
+    ->UseRealTime();
+
+/** @brief Small fan-out graph scheduled in bursts separated by an idle gap long enough for workers to park, as a per-buffer audio graph
+ *  Arguments: worker count, yielding passes, keep a searching worker */
+static void BurstGraph(benchmark::State &state)
+{
+    Flow::Scheduler scheduler(static_cast<std::size_t>(state.range(0)));
+    Flow::Graph graph;
+    auto source = graph.emplace(Flow::EmptyWork);
+
+    scheduler.setStealPolicy(Flow::Scheduler::StealPolicy {
+        .yields = static_cast<std::uint32_t>(state.range(1)),
+        .keepSearching = state.range(2) != 0
+    });
+    for (auto i = 0; i < 16; ++i) {
+        auto leaf = graph.emplace([] {
+            auto x = 0u;
+            for (auto j = 0u; j < 256u; ++j)
+                benchmark::DoNotOptimize(x += j);
+        });
+        source.precede(leaf);
+    }
+    for (auto _ : state) {
+        state.PauseTiming();
+        const auto gap = std::chrono::steady_clock::now() + std::chrono::microseconds(200);
+        while (std::chrono::steady_clock::now() < gap)
+            Flow::CpuPause();
+        state.ResumeTiming();
+        scheduler.schedule(graph);
+        graph.wait();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(graph.size()));
+}
+
+BENCHMARK(BurstGraph)
+    ->ArgNames({ "workers", "yields", "searching" })
+    ->ArgsProduct({ { 2, 4, 8 }, { 0, 64 }, { 0, 1 } })
+    ->UseRealTime();
+
+/** @brief Length of the chains used to measure the per-node overhead */
+constexpr std::size_t ChainLength { 64ul };
+
+/** @brief Chain of empty nodes built with Graph::emplace
+ *  Arguments: compiled graph */
+static void GraphChain(benchmark::State &state)
+{
+    Flow::Scheduler scheduler(1);
+    Flow::Graph graph;
+    auto previous = graph.emplace([] { benchmark::ClobberMemory(); });
+
+    for (auto i = 1ul; i < ChainLength; ++i) {
+        auto task = graph.emplace([] { benchmark::ClobberMemory(); });
+        previous.precede(task);
+        previous = task;
+    }
+    if (state.range(0))
+        graph.compile();
+    for (auto _ : state) {
+        scheduler.schedule(graph);
+        graph.wait();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(ChainLength));
+}
+
+BENCHMARK(GraphChain)
+    ->ArgNames({ "compiled" })
+    ->Arg(0)->Arg(1)
+    ->UseRealTime();
+
+/** @brief Empty node of a static chain */
+template<std::size_t Index>
+struct ChainNode
+{
+    void operator()(void) const noexcept { benchmark::ClobberMemory(); }
+};
+
+template<std::size_t ...Nodes, std::size_t ...Edges>
+auto MakeStaticChain(std::index_sequence<Nodes...>, std::index_sequence<Edges...>)
+    -> Flow::StaticGraph<Flow::StaticNodes<ChainNode<Nodes>...>, Flow::StaticEdges<Flow::StaticEdge<ChainNode<Edges>, ChainNode<Edges + 1ul>>...>>;
+
+/** @brief Chain of empty nodes built with StaticGraph */
+static void StaticGraphChain(benchmark::State &state)
+{
+    using Chain = decltype(MakeStaticChain(std::make_index_sequence<ChainLength>(), std::make_index_sequence<ChainLength - 1ul>()));
+    Flow::Scheduler scheduler(1);
+    Chain chain;
+
+    for (auto _ : state) {
+        scheduler.schedule(chain.graph());
+        chain.graph().wait();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(ChainLength));
+}
+
+BENCHMARK(StaticGraphChain)
+    ->UseRealTime();
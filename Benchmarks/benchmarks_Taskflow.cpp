@@ -0,0 +1,126 @@
+/**
+ * @ Author: Matthieu Moinvaziri
+ * @ Description: taskflow baseline of the scenario benchmarks, only built when the taskflow submodule is checked out
+ */
+
+#include <taskflow/taskflow.hpp>
+
+#include "Scenarios.hpp"
+
+/** @brief Run a taskflow on every iteration
+ *  Arguments: worker count, task granularity
+ *  The builder returns the number of nodes executed per run */
+template<typename Builder>
+static void RunScenario(benchmark::State &state, const Builder &builder)
+{
+    tf::Executor executor(static_cast<std::size_t>(state.range(0)));
+    tf::Taskflow taskflow;
+    const auto granularity = state.range(1);
+
+    const auto nodeCount = builder(taskflow, [granularity] { Scenarios::Spin(granularity); }, granularity);
+    for (auto _ : state)
+        executor.run(taskflow).wait();
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(nodeCount));
+}
+
+static void TaskflowLinearChain(benchmark::State &state)
+{
+    RunScenario(state, [](auto &graph, const auto &work, auto) { return Scenarios::BuildChain(graph, work); });
+}
+
+BENCHMARK(TaskflowLinearChain)->Name("LinearChain/Taskflow")->Apply(Scenarios::SweepWorkers);
+
+static void TaskflowFanOutFanIn(benchmark::State &state)
+{
+    RunScenario(state, [](auto &graph, const auto &work, auto) { return Scenarios::BuildFanOutFanIn(graph, work); });
+}
+
+BENCHMARK(TaskflowFanOutFanIn)->Name("FanOutFanIn/Taskflow")->Apply(Scenarios::SweepWorkers);
+
+static void TaskflowBinaryTree(benchmark::State &state)
+{
+    RunScenario(state, [](auto &graph, const auto &work, auto) { return Scenarios::BuildBinaryTree(graph, work); });
+}
+
+BENCHMARK(TaskflowBinaryTree)->Name("BinaryTree/Taskflow")->Apply(Scenarios::SweepWorkers);
+
+static void TaskflowRandomDag(benchmark::State &state)
+{
+    const auto edges = Scenarios::RandomDagEdges(Scenarios::RandomDagSize);
+
+    RunScenario(state, [&edges](auto &graph, const auto &work, auto) { return Scenarios::BuildRandomDag(graph, work, edges); });
+}
+
+BENCHMARK(TaskflowRandomDag)->Name("RandomDag/Taskflow")->Apply(Scenarios::SweepWorkers);
+
+static void TaskflowSwitchTrees(benchmark::State &state)
+{
+    RunScenario(state, [](auto &graph, const auto &work, const auto granularity) { return Scenarios::BuildSwitchTrees(graph, work, granularity); });
+}
+
+BENCHMARK(TaskflowSwitchTrees)->Name("SwitchTrees/Taskflow")->Apply(Scenarios::SweepWorkers);
+
+/** @brief Source task followed by independent module tasks, each one a chain */
+static void TaskflowNestedGraphs(benchmark::State &state)
+{
+    std::vector<tf::Taskflow> modules(Scenarios::NestedCount);
+
+    RunScenario(state, [&modules](auto &graph, const auto &work, auto) {
+        auto source = graph.emplace(work);
+        for (auto &module : modules) {
+            Scenarios::BuildChain(module, work, Scenarios::NestedSize);
+            source.precede(graph.composed_of(module));
+        }
+        return 1ul + Scenarios::NestedCount * Scenarios::NestedSize;
+    });
+}
+
+BENCHMARK(TaskflowNestedGraphs)->Name("NestedGraphs/Taskflow")->Apply(Scenarios::SweepWorkers);
+
+/** @brief Source task followed by independent subflow tasks, each one building a chain on every run */
+static void TaskflowDynamicNodes(benchmark::State &state)
+{
+    RunScenario(state, [](auto &graph, const auto &work, auto) {
+        auto source = graph.emplace(work);
+        for (auto i = 0ul; i < Scenarios::NestedCount; ++i) {
+            source.precede(graph.emplace([work](tf::Subflow &subflow) {
+                Scenarios::BuildChain(subflow, work, Scenarios::NestedSize);
+            }));
+        }
+        return 1ul + Scenarios::NestedCount * (Scenarios::NestedSize + 1ul);
+    });
+}
+
+BENCHMARK(TaskflowDynamicNodes)->Name("DynamicNodes/Taskflow")->Apply(Scenarios::SweepWorkers);
+
+/** @brief Fan-out / fan-in taskflow run several times in a row */
+static void TaskflowRepeatLoop(benchmark::State &state)
+{
+    tf::Executor executor(static_cast<std::size_t>(state.range(0)));
+    tf::Taskflow taskflow;
+    const auto granularity = state.range(1);
+
+    Scenarios::BuildFanOutFanIn(taskflow, [granularity] { Scenarios::Spin(granularity); });
+    for (auto _ : state)
+        executor.run_n(taskflow, Scenarios::RepeatCount).wait();
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(taskflow.num_tasks() * Scenarios::RepeatCount));
+}
+
+BENCHMARK(TaskflowRepeatLoop)->Name("RepeatLoop/Taskflow")->Apply(Scenarios::SweepWorkers);
+
+/** @brief Construction of a random DAG
+ *  Arguments: node count */
+static void TaskflowConstruction(benchmark::State &state)
+{
+    const auto size = static_cast<std::size_t>(state.range(0));
+    const auto edges = Scenarios::RandomDagEdges(size);
+
+    for (auto _ : state) {
+        tf::Taskflow taskflow;
+        Scenarios::BuildRandomDag(taskflow, [] {}, edges, size);
+        benchmark::DoNotOptimize(taskflow.num_tasks());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(size));
+}
+
+BENCHMARK(TaskflowConstruction)->Name("Construction/Taskflow")->Apply(Scenarios::SweepSizes);
@@ -0,0 +1,209 @@
+/**
+ * @ Author: Matthieu Moinvaziri
+ * @ Description: Parallel algorithms
+ */
+
+#pragma once
+
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include "Scheduler.hpp"
+
+namespace Flow
+{
+    /** @brief Tuning of a parallel algorithm */
+    struct ParallelOptions
+    {
+        std::size_t grainSize { 1ul }; // Minimum number of elements processed at once, a range not larger than it runs serially
+        std::size_t laneCount { 0ul }; // Number of nodes sharing the range, 0 uses the scheduler worker count (or the hardware thread count in a graph)
+    };
+
+    template<typename Iterator>
+    class ParallelRange;
+
+    template<typename Iterator, typename Func>
+    struct ParallelForState;
+
+    template<typename Iterator, typename Value, typename Reduce>
+    struct ParallelReduceState;
+
+    template<typename Iterator, typename Compare>
+    struct ParallelSortState;
+
+    /** @brief Emplace a composite node calling 'func' on each element of [first, last)
+     *  Integral ranges pass each index, iterator ranges pass each dereferenced element and must be random access
+     *  The range is captured when the node is emplaced, the lanes of the composite node grab chunks whose size shrinks
+     *  as the range is consumed so that idle workers stealing a lane still find work */
+    template<typename Iterator, typename Func>
+    Task ParallelFor(Graph &graph, const Iterator first, const Iterator last, Func &&func, const ParallelOptions &options = {});
+
+    /** @brief Emplace a composite node reducing [first, last) into 'result'
+     *  'reduce' must be associative and commutative, it is called with (Value, Element) and (Value, Value) */
+    template<typename Iterator, typename Value, typename Reduce>
+    Task ParallelReduce(Graph &graph, const Iterator first, const Iterator last, Value &result, const Value &identity, Reduce &&reduce,
+            const ParallelOptions &options = {});
+
+    /** @brief Emplace a composite node storing 'func(element)' into 'output' for each element of [first, last), both must be random access */
+    template<typename InputIterator, typename OutputIterator, typename Func>
+    Task ParallelTransform(Graph &graph, const InputIterator first, const InputIterator last, const OutputIterator output, Func &&func,
+            const ParallelOptions &options = {});
+
+    /** @brief Emplace a composite node sorting [first, last), blocks are sorted in parallel then merged pairwise */
+    template<typename Iterator, typename Compare = std::less<>>
+    Task ParallelSort(Graph &graph, const Iterator first, const Iterator last, Compare &&compare = Compare(), const ParallelOptions &options = {});
+
+    /** @brief Run an algorithm on a scheduler and wait for its completion, a range not larger than the grain size runs on the calling thread
+     *  They must not be called from a worker of the scheduler, emplace the algorithm into the node's graph instead */
+    template<typename Iterator, typename Func>
+    void ParallelFor(Scheduler &scheduler, const Iterator first, const Iterator last, Func &&func, const ParallelOptions &options = {});
+
+    template<typename Iterator, typename Value, typename Reduce>
+    [[nodiscard]] Value ParallelReduce(Scheduler &scheduler, const Iterator first, const Iterator last, const Value &identity, Reduce &&reduce,
+            const ParallelOptions &options = {});
+
+    template<typename InputIterator, typename OutputIterator, typename Func>
+    void ParallelTransform(Scheduler &scheduler, const InputIterator first, const InputIterator last, const OutputIterator output, Func &&func,
+            const ParallelOptions &options = {});
+
+    template<typename Iterator, typename Compare = std::less<>>
+    void ParallelSort(Scheduler &scheduler, const Iterator first, const Iterator last, Compare &&compare = Compare(), const ParallelOptions &options = {});
+
+    /** @brief Emplace the nodes of a lane state into 'graph': a reset node, then every lane, then a finish node
+     *  Reserved for internal use ! */
+    template<typename State>
+    void BuildParallelLanes(Graph &graph, std::shared_ptr<State> &&state);
+
+    /** @brief Emplace the lanes of a state as a composite node, or as a single node if the range is serial
+     *  Reserved for internal use ! */
+    template<typename State>
+    [[nodiscard]] Task EmplaceParallelLanes(Graph &graph, std::shared_ptr<State> &&state);
+
+    /** @brief Emplace a node running an empty nested graph, returns the nested graph owned by the node
+     *  Children must be emplaced into the returned graph as nodes keep the address of the graph they are emplaced into
+     *  Reserved for internal use ! */
+    [[nodiscard]] Graph &EmplaceNestedGraph(Graph &graph, Task &task);
+
+    /** @brief Emplace the sort and merge nodes of a sort state into 'graph'
+     *  Reserved for internal use ! */
+    template<typename State>
+    void BuildParallelSort(Graph &graph, std::shared_ptr<State> &&state);
+
+    /** @brief Schedule the graph of an algorithm and wait for its completion
+     *  Reserved for internal use ! */
+    void RunParallelGraph(Scheduler &scheduler, Graph &graph);
+}
+
+/**
+ * @brief Range shared by the lanes of a parallel algorithm
+ *  Chunks are grabbed with guided self-scheduling: each chunk is a fraction of the remaining elements, never smaller than the grain size
+ *  Reserved for internal use !
+ */
+template<typename Iterator>
+class alignas_cacheline Flow::ParallelRange
+{
+    static_assert(std::is_integral_v<Iterator> || std::random_access_iterator<Iterator>,
+        "Flow::ParallelRange: Lanes access elements by index, iterators must be random access");
+
+public:
+    /** @brief Construct the range */
+    ParallelRange(const Iterator first, const Iterator last, const ParallelOptions &options) noexcept;
+
+    /** @brief Get the number of elements */
+    [[nodiscard]] std::size_t size(void) const noexcept { return _count; }
+
+    /** @brief Get the number of lanes sharing the range */
+    [[nodiscard]] std::size_t laneCount(void) const noexcept { return _laneCount; }
+
+    /** @brief Check if the range is processed by a single lane */
+    [[nodiscard]] bool isSerial(void) const noexcept { return _laneCount == 1ul; }
+
+    /** @brief Get an element, the index itself for integral ranges */
+    [[nodiscard]] decltype(auto) operator[](const std::size_t index) const;
+
+    /** @brief Rewind the range before a run */
+    void reset(void) noexcept { _cursor.store(0ul, std::memory_order_relaxed); }
+
+    /** @brief Grab the next chunk [begin, end), returns false once the range is consumed */
+    [[nodiscard]] bool next(std::size_t &begin, std::size_t &end) noexcept;
+
+    /** @brief Get the default lane count of an algorithm emplaced in a graph */
+    [[nodiscard]] static std::size_t DefaultLaneCount(void) noexcept;
+
+private:
+    Iterator _first;
+    std::size_t _count { 0ul };
+    std::size_t _grainSize { 1ul };
+    std::size_t _laneCount { 1ul };
+    alignas_cacheline std::atomic<std::size_t> _cursor { 0ul };
+};
+
+/** @brief Lanes of a parallel for
+ *  Reserved for internal use ! */
+template<typename Iterator, typename Func>
+struct Flow::ParallelForState
+{
+    ParallelRange<Iterator> range;
+    Func func;
+
+    template<typename Callable>
+    ParallelForState(const Iterator first, const Iterator last, Callable &&callable, const ParallelOptions &options)
+        : range(first, last, options), func(std::forward<Callable>(callable)) {}
+
+    /** @brief Process chunks until the range is consumed */
+    void runLane(const std::size_t laneIndex);
+
+    /** @brief Called once every lane is completed */
+    void finish(void) noexcept {}
+};
+
+/** @brief Lanes of a parallel reduce, each lane reduces its chunks into its own partial value
+ *  Reserved for internal use ! */
+template<typename Iterator, typename Value, typename Reduce>
+struct Flow::ParallelReduceState
+{
+    ParallelRange<Iterator> range;
+    Value identity;
+    Reduce reduce;
+    Value *result;
+    std::vector<Value> partials;
+
+    template<typename Callable>
+    ParallelReduceState(const Iterator first, const Iterator last, Value &output, const Value &initial, Callable &&callable, const ParallelOptions &options)
+        : range(first, last, options), identity(initial), reduce(std::forward<Callable>(callable)), result(&output), partials(range.laneCount(), initial) {}
+
+    /** @brief Reduce chunks until the range is consumed */
+    void runLane(const std::size_t laneIndex);
+
+    /** @brief Reduce the partial values into the result */
+    void finish(void);
+};
+
+/** @brief Steps of a parallel sort, blocks are sorted then merged pairwise as a binary tree
+ *  Reserved for internal use ! */
+template<typename Iterator, typename Compare>
+struct Flow::ParallelSortState
+{
+    /** @brief Sort [begin, end) if 'middle' equals 'end', else merge [begin, middle) and [middle, end) */
+    struct Step
+    {
+        std::size_t begin;
+        std::size_t middle;
+        std::size_t end;
+    };
+
+    Iterator first;
+    Compare compare;
+    std::size_t blockCount { 1ul };
+    std::vector<Step> steps {};
+
+    template<typename Callable>
+    ParallelSortState(const Iterator begin, const Iterator end, Callable &&callable, const ParallelOptions &options);
+
+    /** @brief Execute a step */
+    void run(const std::size_t stepIndex);
+};
+
+#include "Algorithms.ipp"
@@ -0,0 +1,305 @@
+/**
+ * @ Author: Matthieu Moinvaziri
+ * @ Description: Parallel algorithms
+ */
+
+#include <algorithm>
+
+template<typename Iterator>
+inline Flow::ParallelRange<Iterator>::ParallelRange(const Iterator first, const Iterator last, const ParallelOptions &options) noexcept
+    : _first(first), _grainSize(std::max(options.grainSize, std::size_t { 1 }))
+{
+    if constexpr (std::is_integral_v<Iterator>)
+        _count = last > first ? static_cast<std::size_t>(last - first) : 0ul;
+    else
+        _count = static_cast<std::size_t>(std::distance(first, last));
+    const auto laneCount = options.laneCount ? options.laneCount : DefaultLaneCount();
+    const auto chunkCount = (_count + _grainSize - 1ul) / _grainSize;
+    _laneCount = std::max(std::min(laneCount, chunkCount), std::size_t { 1 });
+}
+
+template<typename Iterator>
+inline decltype(auto) Flow::ParallelRange<Iterator>::operator[](const std::size_t index) const
+{
+    if constexpr (std::is_integral_v<Iterator>)
+        return static_cast<Iterator>(_first + static_cast<Iterator>(index));
+    else
+        return _first[static_cast<typename std::iterator_traits<Iterator>::difference_type>(index)];
+}
+
+template<typename Iterator>
+inline bool Flow::ParallelRange<Iterator>::next(std::size_t &begin, std::size_t &end) noexcept
+{
+    auto cursor = _cursor.load(std::memory_order_relaxed);
+    std::size_t chunk;
+
+    do {
+        if (cursor >= _count)
+            return false;
+        const auto remaining = _count - cursor;
+        chunk = std::min(std::max(remaining / (_laneCount * 2ul), _grainSize), remaining);
+    } while (!_cursor.compare_exchange_weak(cursor, cursor + chunk, std::memory_order_relaxed));
+    begin = cursor;
+    end = cursor + chunk;
+    return true;
+}
+
+template<typename Iterator>
+inline std::size_t Flow::ParallelRange<Iterator>::DefaultLaneCount(void) noexcept
+{
+    const auto count = static_cast<std::size_t>(std::thread::hardware_concurrency());
+
+    return count ? count : Scheduler::DefaultWorkerCount;
+}
+
+template<typename Iterator, typename Func>
+inline void Flow::ParallelForState<Iterator, Func>::runLane(const std::size_t)
+{
+    for (std::size_t begin, end; range.next(begin, end);) {
+        for (auto i = begin; i != end; ++i)
+            func(range[i]);
+    }
+}
+
+template<typename Iterator, typename Value, typename Reduce>
+inline void Flow::ParallelReduceState<Iterator, Value, Reduce>::runLane(const std::size_t laneIndex)
+{
+    Value value = identity;
+
+    for (std::size_t begin, end; range.next(begin, end);) {
+        for (auto i = begin; i != end; ++i)
+            value = reduce(std::move(value), range[i]);
+    }
+    partials[laneIndex] = std::move(value);
+}
+
+template<typename Iterator, typename Value, typename Reduce>
+inline void Flow::ParallelReduceState<Iterator, Value, Reduce>::finish(void)
+{
+    Value value = identity;
+
+    for (auto &partial : partials)
+        value = reduce(std::move(value), partial);
+    *result = std::move(value);
+}
+
+template<typename Iterator, typename Compare>
+template<typename Callable>
+inline Flow::ParallelSortState<Iterator, Compare>::ParallelSortState(const Iterator begin, const Iterator end, Callable &&callable, const ParallelOptions &options)
+    : first(begin), compare(std::forward<Callable>(callable))
+{
+    const auto count = static_cast<std::size_t>(std::distance(begin, end));
+    const auto grainSize = std::max(options.grainSize, std::size_t { 1 });
+    const auto laneCount = options.laneCount ? options.laneCount : ParallelRange<Iterator>::DefaultLaneCount();
+    const auto bound = [this, count](const std::size_t block) { return count * block / blockCount; };
+
+    // Block count is a power of 2 so that blocks are merged as a complete binary tree
+    while (blockCount < laneCount && count / (blockCount * 2ul) >= grainSize)
+        blockCount *= 2ul;
+    steps.reserve(blockCount * 2ul - 1ul);
+    for (auto i = 0ul; i < blockCount; ++i)
+        steps.push_back(Step { bound(i), bound(i + 1ul), bound(i + 1ul) });
+    for (auto width = 2ul; width <= blockCount; width *= 2ul) {
+        for (auto i = 0ul; i < blockCount; i += width)
+            steps.push_back(Step { bound(i), bound(i + width / 2ul), bound(i + width) });
+    }
+}
+
+template<typename Iterator, typename Compare>
+inline void Flow::ParallelSortState<Iterator, Compare>::run(const std::size_t stepIndex)
+{
+    using Difference = typename std::iterator_traits<Iterator>::difference_type;
+    const auto &step = steps[stepIndex];
+    const auto begin = std::next(first, static_cast<Difference>(step.begin));
+    const auto middle = std::next(first, static_cast<Difference>(step.middle));
+    const auto end = std::next(first, static_cast<Difference>(step.end));
+
+    if (step.middle == step.end)
+        std::sort(begin, end, compare);
+    else
+        std::inplace_merge(begin, middle, end, compare);
+}
+
+template<typename State>
+inline void Flow::BuildParallelLanes(Graph &graph, std::shared_ptr<State> &&state)
+{
+    auto * const raw = state.get();
+    auto reset = graph.emplace([raw] { raw->range.reset(); });
+    // The finish node owns the state, lanes only reference it
+    auto finish = graph.emplace([state = std::move(state)] { state->finish(); });
+    for (auto i = 0ul; i < raw->range.laneCount(); ++i) {
+        auto lane = graph.emplace([raw, i] { raw->runLane(i); });
+        reset.precede(lane);
+        lane.precede(finish);
+    }
+}
+
+template<typename State>
+inline void Flow::BuildParallelSort(Graph &graph, std::shared_ptr<State> &&state)
+{
+    auto * const raw = state.get();
+    const auto blockCount = raw->blockCount;
+    const auto stepCount = raw->steps.size();
+    std::vector<Task> steps;
+
+    steps.reserve(stepCount);
+    for (auto i = 0ul; i < stepCount; ++i) {
+        // The root step owns the state, other steps only reference it
+        auto step = i + 1ul == stepCount ? graph.emplace([state = std::move(state), i] { state->run(i); }) : graph.emplace([raw, i] { raw->run(i); });
+        // Merge steps are stored level by level, so the n-th merge joins the steps 2n and 2n + 1
+        if (i >= blockCount) {
+            steps[(i - blockCount) * 2ul].precede(step);
+            steps[(i - blockCount) * 2ul + 1ul].precede(step);
+        }
+        steps.push_back(step);
+    }
+}
+
+template<typename State>
+inline Flow::Task Flow::EmplaceParallelLanes(Graph &graph, std::shared_ptr<State> &&state)
+{
+    if (state->range.isSerial()) {
+        return graph.emplace([state = std::move(state)] {
+            state->range.reset();
+            state->runLane(0ul);
+            state->finish();
+        });
+    }
+    Task task;
+    BuildParallelLanes(EmplaceNestedGraph(graph, task), std::move(state));
+    return task;
+}
+
+inline Flow::Graph &Flow::EmplaceNestedGraph(Graph &graph, Task &task)
+{
+    Graph nested;
+
+    nested.construct();
+    task = graph.emplace(nested);
+    return std::get<static_cast<std::size_t>(NodeType::Graph)>(task.node()->workData);
+}
+
+inline void Flow::RunParallelGraph(Scheduler &scheduler, Graph &graph)
+{
+    if (const auto * const worker = Worker::Current(); worker && worker->parent() == &scheduler)
+        throw std::logic_error("Flow::RunParallelGraph: Can't block a worker of the scheduler, emplace the algorithm into a graph instead");
+    scheduler.schedule(graph);
+    graph.wait();
+}
+
+template<typename Iterator, typename Func>
+inline Flow::Task Flow::ParallelFor(Graph &graph, const Iterator first, const Iterator last, Func &&func, const ParallelOptions &options)
+{
+    return EmplaceParallelLanes(graph, std::make_shared<ParallelForState<Iterator, std::decay_t<Func>>>(first, last, std::forward<Func>(func), options));
+}
+
+template<typename Iterator, typename Value, typename Reduce>
+inline Flow::Task Flow::ParallelReduce(Graph &graph, const Iterator first, const Iterator last, Value &result, const Value &identity, Reduce &&reduce,
+        const ParallelOptions &options)
+{
+    return EmplaceParallelLanes(graph,
+        std::make_shared<ParallelReduceState<Iterator, Value, std::decay_t<Reduce>>>(first, last, result, identity, std::forward<Reduce>(reduce), options));
+}
+
+template<typename InputIterator, typename OutputIterator, typename Func>
+inline Flow::Task Flow::ParallelTransform(Graph &graph, const InputIterator first, const InputIterator last, const OutputIterator output, Func &&func,
+        const ParallelOptions &options)
+{
+    static_assert(std::random_access_iterator<InputIterator> && std::random_access_iterator<OutputIterator>,
+        "Flow::ParallelTransform: Lanes access elements by index, iterators must be random access");
+
+    const auto count = static_cast<std::size_t>(std::distance(first, last));
+
+    return ParallelFor(graph, 0ul, count, [first, output, func = std::forward<Func>(func)](const std::size_t index) mutable {
+        output[static_cast<typename std::iterator_traits<OutputIterator>::difference_type>(index)] =
+            func(first[static_cast<typename std::iterator_traits<InputIterator>::difference_type>(index)]);
+    }, options);
+}
+
+template<typename Iterator, typename Compare>
+inline Flow::Task Flow::ParallelSort(Graph &graph, const Iterator first, const Iterator last, Compare &&compare, const ParallelOptions &options)
+{
+    auto state = std::make_shared<ParallelSortState<Iterator, std::decay_t<Compare>>>(first, last, std::forward<Compare>(compare), options);
+
+    if (state->blockCount == 1ul)
+        return graph.emplace([state = std::move(state)] { state->run(0ul); });
+    Task task;
+    BuildParallelSort(EmplaceNestedGraph(graph, task), std::move(state));
+    return task;
+}
+
+namespace Flow
+{
+    /** @brief Use the worker count of the scheduler as default lane count */
+    [[nodiscard]] inline ParallelOptions SchedulerOptions(const Scheduler &scheduler, const ParallelOptions &options) noexcept
+    {
+        auto schedulerOptions = options;
+
+        if (!schedulerOptions.laneCount)
+            schedulerOptions.laneCount = scheduler.workerCount();
+        return schedulerOptions;
+    }
+}
+
+template<typename Iterator, typename Func>
+inline void Flow::ParallelFor(Scheduler &scheduler, const Iterator first, const Iterator last, Func &&func, const ParallelOptions &options)
+{
+    auto state = std::make_shared<ParallelForState<Iterator, std::decay_t<Func>>>(first, last, std::forward<Func>(func), SchedulerOptions(scheduler, options));
+
+    if (state->range.isSerial()) {
+        state->runLane(0ul);
+        return;
+    }
+    Graph graph;
+    BuildParallelLanes(graph, std::move(state));
+    RunParallelGraph(scheduler, graph);
+}
+
+template<typename Iterator, typename Value, typename Reduce>
+inline Value Flow::ParallelReduce(Scheduler &scheduler, const Iterator first, const Iterator last, const Value &identity, Reduce &&reduce,
+        const ParallelOptions &options)
+{
+    Value result = identity;
+    auto state = std::make_shared<ParallelReduceState<Iterator, Value, std::decay_t<Reduce>>>(
+        first, last, result, identity, std::forward<Reduce>(reduce), SchedulerOptions(scheduler, options));
+
+    if (state->range.isSerial()) {
+        state->runLane(0ul);
+        state->finish();
+        return result;
+    }
+    Graph graph;
+    BuildParallelLanes(graph, std::move(state));
+    RunParallelGraph(scheduler, graph);
+    return result;
+}
+
+template<typename InputIterator, typename OutputIterator, typename Func>
+inline void Flow::ParallelTransform(Scheduler &scheduler, const InputIterator first, const InputIterator last, const OutputIterator output, Func &&func,
+        const ParallelOptions &options)
+{
+    static_assert(std::random_access_iterator<InputIterator> && std::random_access_iterator<OutputIterator>,
+        "Flow::ParallelTransform: Lanes access elements by index, iterators must be random access");
+
+    const auto count = static_cast<std::size_t>(std::distance(first, last));
+
+    ParallelFor(scheduler, 0ul, count, [first, output, func = std::forward<Func>(func)](const std::size_t index) mutable {
+        output[static_cast<typename std::iterator_traits<OutputIterator>::difference_type>(index)] =
+            func(first[static_cast<typename std::iterator_traits<InputIterator>::difference_type>(index)]);
+    }, options);
+}
+
+template<typename Iterator, typename Compare>
+inline void Flow::ParallelSort(Scheduler &scheduler, const Iterator first, const Iterator last, Compare &&compare, const ParallelOptions &options)
+{
+    auto state = std::make_shared<ParallelSortState<Iterator, std::decay_t<Compare>>>(
+        first, last, std::forward<Compare>(compare), SchedulerOptions(scheduler, options));
+
+    if (state->blockCount == 1ul) {
+        state->run(0ul);
+        return;
+    }
+    Graph graph;
+    BuildParallelSort(graph, std::move(state));
+    RunParallelGraph(scheduler, graph);
+}
@@ -19,4 +19,36 @@ namespace atomic_sync
     using std::atomic_notify_all;
 }
 
-#endif
\ No newline at end of file
+#endif
+
+#include <chrono>
+#include <thread>
+
+#include "Backoff.hpp"
+
+namespace Flow
+{
+    /** @brief Wait until 'value' differs from 'old' or 'timeout' is reached, returns false on timeout
+     *  The bundled atomic_wait has no timed variant, so this spins, yields then sleeps with a growing period */
+    template<typename Type, typename Clock, typename Duration>
+    [[nodiscard]] bool AtomicWaitUntil(const std::atomic<Type> &value, const Type old, const std::chrono::time_point<Clock, Duration> &timeout) noexcept
+    {
+        constexpr std::chrono::microseconds MaxSleepPeriod { 100 };
+        std::chrono::microseconds period { 1 };
+
+        for (auto i = 0u; value.load(std::memory_order_acquire) == old; ++i) {
+            if (Clock::now() >= timeout)
+                return false;
+            if (i < 64u)
+                CpuPause();
+            else if (i < 128u)
+                std::this_thread::yield();
+            else {
+                std::this_thread::sleep_for(period);
+                if (period < MaxSleepPeriod)
+                    period *= 2;
+            }
+        }
+        return true;
+    }
+}
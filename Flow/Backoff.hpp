@@ -0,0 +1,53 @@
+/**
+ * @ Author: Matthieu Moinvaziri
+ * @ Description: Spin backoff helpers
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+# include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+# include <immintrin.h>
+#endif
+
+namespace Flow
+{
+    /** @brief Hint the processor that the current thread is spinning */
+    inline void CpuPause(void) noexcept
+    {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        _mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        asm volatile("yield" ::: "memory");
+#endif
+    }
+
+    class Backoff;
+}
+
+/** @brief Exponential spin backoff, each pause doubles the spin count until it reaches its maximum */
+class Flow::Backoff
+{
+public:
+    /** @brief Construct the backoff with a spin range */
+    Backoff(const std::uint32_t minSpins, const std::uint32_t maxSpins) noexcept
+        : _spins(minSpins ? minSpins : 1u), _maxSpins(maxSpins) {}
+
+    /** @brief Spin for the current count then double it */
+    void pause(void) noexcept
+    {
+        for (auto i = 0u; i < _spins; ++i)
+            CpuPause();
+        if (_spins < _maxSpins)
+            _spins = _spins * 2u < _maxSpins ? _spins * 2u : _maxSpins;
+    }
+
+private:
+    std::uint32_t _spins;
+    std::uint32_t _maxSpins;
+};
@@ -0,0 +1,155 @@
+/**
+ * @ Author: Matthieu Moinvaziri
+ * @ Description: Compiled graph
+ */
+
+#include <algorithm>
+
+#include "Graph.hpp"
+
+void Flow::CompiledGraph::prepareStaticRun(const std::uint32_t workerCount)
+{
+    auto &schedule = *staticSchedule;
+    std::uint64_t totalCost { 0u };
+
+    for (const auto cost : schedule.costs)
+        totalCost += cost;
+    if (schedule.workerCount != workerCount) {
+        planStaticSchedule(workerCount);
+        return;
+    }
+    // Plan with the first measures, then only once they drifted too much
+    const auto planned = schedule.plannedCost;
+    if (!totalCost || (planned && (totalCost > planned ? totalCost - planned : planned - totalCost) * StaticSchedule::DriftDivisor <= planned))
+        return;
+    planStaticSchedule(workerCount);
+}
+
+void Flow::CompiledGraph::allocateStaticSchedule(void)
+{
+    staticSchedule = std::make_unique<StaticSchedule>();
+    auto &schedule = *staticSchedule;
+    const auto count = static_cast<std::uint32_t>(nodes.size());
+
+    schedule.costs.allocate(count, 0u);
+    schedule.workers.allocate(count, 0u);
+    schedule.laneNext.allocate(count, StaticSchedule::NoIndex);
+    schedule.joinCounts.allocate(count, 0u);
+    schedule.heads.reserve(count);
+    schedule.order.allocate(count);
+    schedule.ranks.allocate(count, 0u);
+    schedule.finishes.allocate(count, 0u);
+
+    // Predecessors in CSR form
+    schedule.predecessorOffsets.allocate(count + 1u, 0u);
+    schedule.predecessors.allocate(successors.size());
+    for (const auto successor : successors)
+        ++schedule.predecessorOffsets[successor + 1u];
+    for (std::uint32_t index = 0u; index != count; ++index)
+        schedule.predecessorOffsets[index + 1u] += schedule.predecessorOffsets[index];
+    {
+        Core::HeapArray<std::uint32_t> cursors;
+        cursors.allocate(count);
+        std::copy_n(schedule.predecessorOffsets.begin(), count, cursors.begin());
+        for (std::uint32_t index = 0u; index != count; ++index) {
+            for (auto it = successorsBegin(index), end = successorsEnd(index); it != end; ++it)
+                schedule.predecessors[cursors[*it]++] = index;
+        }
+    }
+
+    // Topological order, only the ranks derived from it depend on the measured costs
+    schedule.topology.allocate(count);
+    {
+        Core::HeapArray<std::uint32_t> pendings;
+        std::uint32_t size { 0u };
+        pendings.allocate(count);
+        std::copy_n(joinCounts.begin(), count, pendings.begin());
+        for (std::uint32_t index = 0u; index != count; ++index) {
+            if (!joinCounts[index])
+                schedule.topology[size++] = index;
+        }
+        for (std::uint32_t i = 0u; i != size; ++i) {
+            for (auto it = successorsBegin(schedule.topology[i]), end = successorsEnd(schedule.topology[i]); it != end; ++it) {
+                if (!--pendings[*it])
+                    schedule.topology[size++] = *it;
+            }
+        }
+    }
+}
+
+void Flow::CompiledGraph::planStaticSchedule(const std::uint32_t workerCount)
+{
+    auto &schedule = *staticSchedule;
+    auto &order = schedule.order;
+    auto &ranks = schedule.ranks;
+    auto &finishes = schedule.finishes;
+    auto &available = schedule.available;
+    auto &laneTails = schedule.laneTails;
+    const auto &predecessorOffsets = schedule.predecessorOffsets;
+    const auto &predecessors = schedule.predecessors;
+    const auto count = static_cast<std::uint32_t>(nodes.size());
+    const auto costOf = [&schedule](const std::uint32_t index) -> std::uint64_t {
+        return schedule.costs[index] ? schedule.costs[index] : 1u;
+    };
+
+    // Upward ranks, computed in reverse topological order
+    for (auto i = count; i; --i) {
+        const auto index = schedule.topology[i - 1u];
+        std::uint64_t rank { 0u };
+        for (auto it = successorsBegin(index), end = successorsEnd(index); it != end; ++it)
+            rank = std::max(rank, ranks[*it]);
+        ranks[index] = rank + costOf(index);
+    }
+
+    // Ranks strictly decrease along edges, so sorting by decreasing rank keeps a topological order, ties are broken by index to stay deterministic
+    std::copy_n(schedule.topology.begin(), count, order.begin());
+    std::sort(order.begin(), order.end(), [&ranks](const std::uint32_t lhs, const std::uint32_t rhs) {
+        return ranks[lhs] > ranks[rhs] || (ranks[lhs] == ranks[rhs] && lhs < rhs);
+    });
+
+    // Assign each node to the worker with the earliest finish time, appending it to the worker's lane
+    if (available.size() != workerCount) {
+        available.allocate(workerCount);
+        laneTails.allocate(workerCount);
+    }
+    std::fill(available.begin(), available.end(), 0u);
+    std::fill(laneTails.begin(), laneTails.end(), StaticSchedule::NoIndex);
+    std::fill(schedule.laneNext.begin(), schedule.laneNext.end(), StaticSchedule::NoIndex);
+    std::fill(schedule.joinCounts.begin(), schedule.joinCounts.end(), 0u);
+    for (const auto index : order) {
+        std::uint32_t bestWorker { 0u };
+        std::uint64_t bestFinish { ~0ull };
+        for (std::uint32_t worker = 0u; worker != workerCount; ++worker) {
+            auto start = available[worker];
+            for (auto i = predecessorOffsets[index], end = predecessorOffsets[index + 1u]; i != end; ++i) {
+                const auto predecessor = predecessors[i];
+                const auto cost = schedule.workers[predecessor] == worker ? 0u : StaticSchedule::CrossWorkerCost;
+                start = std::max(start, finishes[predecessor] + cost);
+            }
+            if (const auto finish = start + costOf(index); finish < bestFinish) {
+                bestFinish = finish;
+                bestWorker = worker;
+            }
+        }
+        schedule.workers[index] = bestWorker;
+        finishes[index] = bestFinish;
+        available[bestWorker] = bestFinish;
+        if (const auto tail = laneTails[bestWorker]; tail != StaticSchedule::NoIndex) {
+            schedule.laneNext[tail] = index;
+            ++schedule.joinCounts[index];
+        }
+        laneTails[bestWorker] = index;
+        for (auto i = predecessorOffsets[index], end = predecessorOffsets[index + 1u]; i != end; ++i)
+            schedule.joinCounts[index] += schedule.workers[predecessors[i]] != bestWorker;
+    }
+
+    schedule.heads.clear();
+    for (std::uint32_t index = 0u; index != count; ++index) {
+        if (!schedule.joinCounts[index])
+            schedule.heads.push(index);
+    }
+    schedule.plannedCost = 0u;
+    for (const auto cost : schedule.costs)
+        schedule.plannedCost += cost;
+    schedule.workerCount = workerCount;
+}
@@ -0,0 +1,104 @@
+/**
+ * @ Author: Matthieu Moinvaziri
+ * @ Description: Compiled graph
+ */
+
+#pragma once
+
+// This header must no be directly included, include 'Graph' instead
+
+#include <atomic>
+#include <memory>
+
+#include <Core/HeapArray.hpp>
+#include <Core/FlatVector.hpp>
+
+#include "NodeType.hpp"
+
+namespace Flow
+{
+    struct Node;
+    struct CompiledGraph;
+}
+
+/**
+ * @brief Frozen structure-of-arrays representation of a graph topology, built by Graph::compile
+ *  Nodes are indexed by work type: static nodes come first, then dynamic, switch, graph and coroutine nodes
+ *  Successors are stored in CSR form, 'successors[successorOffsets[i], successorOffsets[i + 1][' are the successors of node 'i'
+ *  Work functors of static nodes are moved into a dense array, they are moved back into their nodes once the compiled form is dropped
+ */
+struct alignas_cacheline Flow::CompiledGraph
+{
+    /** @brief Number of node types */
+    static constexpr std::size_t TypeCount { static_cast<std::size_t>(NodeType::Coroutine) + 1ul };
+
+    Core::HeapArray<Node *> nodes {}; // Nodes sorted by work type
+    Core::HeapArray<std::uint32_t> successorOffsets {}; // CSR row offsets, one per node plus the end offset
+    Core::HeapArray<std::uint32_t> successors {}; // CSR successor indexes
+    Core::HeapArray<std::uint32_t> joinCounts {}; // Number of predecessors of each node
+    Core::HeapArray<std::atomic<std::uint32_t>> joined {}; // Packed join counters
+    Core::HeapArray<StaticFunc> staticWorks {}; // Work functors of static nodes, moved out of their nodes while compiled
+    std::uint32_t typeOffsets[TypeCount + 1ul] {}; // First index of each node type, plus the node count
+
+    /**
+     * @brief Static schedule replayed on every run, planned from the measured costs of the previous runs
+     *  Each node is assigned to a worker lane, nodes of a lane are executed in a fixed order
+     *  Only predecessors of other lanes use join counters, predecessors of the same lane are implied by the lane order
+     */
+    struct StaticSchedule
+    {
+        /** @brief Index of a node without lane successor */
+        static constexpr std::uint32_t NoIndex { ~0u };
+
+        /** @brief Estimated cost in nanoseconds of a dependency between two workers */
+        static constexpr std::uint64_t CrossWorkerCost { 500u };
+
+        /** @brief Relative drift of the measured costs that triggers a new plan (1 / DriftDivisor) */
+        static constexpr std::uint64_t DriftDivisor { 4u };
+
+        Core::HeapArray<std::uint32_t> costs {}; // Measured cost of each node in nanoseconds
+        Core::HeapArray<std::uint32_t> workers {}; // Assigned worker of each node
+        Core::HeapArray<std::uint32_t> laneNext {}; // Next node in the lane of the assigned worker
+        Core::HeapArray<std::uint32_t> joinCounts {}; // Predecessors on other lanes, plus one for the lane predecessor
+        Core::FlatVector<std::uint32_t> heads {}; // Nodes ready at the start of a run
+        Core::HeapArray<std::uint32_t> predecessorOffsets {}; // Predecessors in CSR form, frozen with the topology
+        Core::HeapArray<std::uint32_t> predecessors {};
+        Core::HeapArray<std::uint32_t> topology {}; // Topological order of the nodes
+        Core::HeapArray<std::uint32_t> order {}; // Planning scratch, nodes by decreasing rank
+        Core::HeapArray<std::uint64_t> ranks {}; // Planning scratch, upward rank of each node
+        Core::HeapArray<std::uint64_t> finishes {}; // Planning scratch, estimated finish time of each node
+        Core::HeapArray<std::uint64_t> available {}; // Planning scratch, estimated finish time of each lane
+        Core::HeapArray<std::uint32_t> laneTails {}; // Planning scratch, last node of each lane
+        std::uint64_t plannedCost { 0u }; // Total measured cost used by the current plan, 0 if planned without measures
+        std::uint32_t workerCount { 0u }; // Worker count of the current plan
+    };
+
+    std::unique_ptr<StaticSchedule> staticSchedule {}; // Null unless compiled with ScheduleMode::Static
+
+    /** @brief Get the number of static nodes, their indexes are in range [0, staticCount()[ */
+    [[nodiscard]] std::uint32_t staticCount(void) const noexcept { return typeOffsets[1]; }
+
+    /** @brief Get the successor index range of a node */
+    [[nodiscard]] const std::uint32_t *successorsBegin(const std::uint32_t index) const noexcept
+        { return successors.data() + successorOffsets[index]; }
+    [[nodiscard]] const std::uint32_t *successorsEnd(const std::uint32_t index) const noexcept
+        { return successors.data() + successorOffsets[index + 1u]; }
+
+    /** @brief Record the measured cost of a node, smoothed over runs */
+    void recordCost(const std::uint32_t index, const std::uint64_t nanoseconds) noexcept
+    {
+        auto &cost = staticSchedule->costs[index];
+        const auto sample = static_cast<std::uint32_t>(nanoseconds < ~0u ? nanoseconds : ~0u);
+        cost = cost ? static_cast<std::uint32_t>((static_cast<std::uint64_t>(cost) * 3u + sample) / 4u) : sample;
+    }
+
+    /** @brief Create the static schedule with the topology and the buffers reused by every plan */
+    void allocateStaticSchedule(void);
+
+    /** @brief Plan the static schedule again if the worker count changed or the measured costs drifted */
+    void prepareStaticRun(const std::uint32_t workerCount);
+
+    /** @brief Assign nodes to worker lanes with a list-scheduling heuristic (HEFT without insertion)
+     *  Only allocates when the worker count changed, other buffers are allocated with the static schedule */
+    void planStaticSchedule(const std::uint32_t workerCount);
+};
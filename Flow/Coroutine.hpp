@@ -0,0 +1,214 @@
+/**
+ * @ Author: Matthieu Moinvaziri
+ * @ Description: Coroutine node
+ */
+
+#pragma once
+
+// This header must no be directly included, include 'Scheduler' instead
+
+#include <coroutine>
+#include <exception>
+#include <type_traits>
+#include <utility>
+
+namespace Flow
+{
+    struct Node;
+    class Graph;
+
+    class Coroutine;
+    class CoroutineResumer;
+
+    /** @brief Check if a type is a complete awaiter (await_ready, await_suspend and await_resume) */
+    template<typename Awaiter>
+    concept IsAwaiter = requires(Awaiter &awaiter, std::coroutine_handle<> handle) {
+        { awaiter.await_ready() } -> std::convertible_to<bool>;
+        awaiter.await_suspend(handle);
+        awaiter.await_resume();
+    };
+
+    /** @brief Resume a coroutine node by dispatching it again on a worker of its scheduler
+     *  Reserved for internal use ! */
+    void ResumeCoroutine(Node * const node) noexcept;
+}
+
+/**
+ * @brief Return type of the work of a coroutine node
+ *  A coroutine node is joined once its coroutine returns, not when it first suspends
+ *  While suspended the node doesn't hold any worker, it is resumed on a worker of its scheduler once its dependency completes
+ *  The coroutine may co_await:
+ *   - A Flow::Graph, scheduled as a nested run of the node's graph, any exception of the nested run is rethrown by co_await
+ *   - Any awaiter (await_ready, await_suspend and await_resume), its 'await_suspend' must return void or bool
+ *     The awaiter may resume from any thread, the coroutine always continues on a worker
+ *
+ * @example
+ *  graph.emplace([&]() -> Flow::Coroutine {
+ *      co_await decodeGraph;
+ *      co_await stream.read(buffer); // User awaiter resumed by an I/O thread
+ *      process(buffer);
+ *  });
+ */
+class Flow::Coroutine
+{
+public:
+    class promise_type;
+
+    /** @brief Handle of the coroutine */
+    using Handle = std::coroutine_handle<promise_type>;
+
+    /** @brief Awaiter of a nested graph */
+    class GraphAwaiter;
+
+    /** @brief Awaiter wrapping a user awaiter to resume the coroutine on a worker */
+    template<typename Awaiter>
+    class ExternalAwaiter;
+
+    /** @brief Coroutines can only be moved */
+    Coroutine(const Coroutine &other) = delete;
+    Coroutine(Coroutine &&other) noexcept : _handle(std::exchange(other._handle, nullptr)) {}
+    Coroutine &operator=(const Coroutine &other) = delete;
+    Coroutine &operator=(Coroutine &&other) noexcept { std::swap(_handle, other._handle); return *this; }
+
+    /** @brief Destroy the coroutine if it was not released */
+    ~Coroutine(void) { if (_handle) _handle.destroy(); }
+
+    /** @brief Release the ownership of the coroutine handle */
+    [[nodiscard]] Handle release(void) noexcept { return std::exchange(_handle, nullptr); }
+
+private:
+    Handle _handle {};
+
+    /** @brief Default constructor, a coroutine node can't return an empty coroutine */
+    Coroutine(void) noexcept = default;
+
+    /** @brief Construct from a handle */
+    explicit Coroutine(const Handle handle) noexcept : _handle(handle) {}
+};
+
+/** @brief Promise of a coroutine node */
+class Flow::Coroutine::promise_type
+{
+public:
+    /** @brief Awaiter of the final suspension, the coroutine frame is destroyed by the worker that resumed it last */
+    struct FinalAwaiter
+    {
+        [[nodiscard]] bool await_ready(void) const noexcept { return false; }
+        void await_suspend(const Handle handle) const noexcept { *handle.promise()._completed = true; }
+        void await_resume(void) const noexcept {}
+    };
+
+    /** @brief Coroutine interface */
+    [[nodiscard]] Coroutine get_return_object(void) noexcept { return Coroutine(Handle::from_promise(*this)); }
+    [[nodiscard]] std::suspend_always initial_suspend(void) const noexcept { return {}; }
+    [[nodiscard]] FinalAwaiter final_suspend(void) const noexcept { return {}; }
+    void return_void(void) const noexcept {}
+    void unhandled_exception(void) noexcept { _exception = std::current_exception(); }
+
+    /** @brief Transform awaited expressions */
+    [[nodiscard]] GraphAwaiter await_transform(Graph &graph) const noexcept;
+
+    template<typename Awaiter> requires IsAwaiter<std::remove_reference_t<Awaiter>>
+    [[nodiscard]] ExternalAwaiter<Awaiter> await_transform(Awaiter &&awaiter) const noexcept
+        { return ExternalAwaiter<Awaiter>(std::forward<Awaiter>(awaiter), _node); }
+
+    /** @brief Get the exception thrown by the coroutine, null if none */
+    [[nodiscard]] std::exception_ptr exception(void) const noexcept { return _exception; }
+
+    /** @brief Bind the coroutine to its node
+     *  Reserved for internal use ! */
+    void setNode(Node * const node) noexcept { _node = node; }
+
+    /** @brief Set the flag raised if the coroutine completes before the resuming worker regains control
+     *  Must be set before each resume, the flag is owned by the resuming worker
+     *  Reserved for internal use ! */
+    void setCompletedFlag(bool * const completed) noexcept { _completed = completed; }
+
+private:
+    Node *_node { nullptr };
+    bool *_completed { nullptr };
+    std::exception_ptr _exception {};
+};
+
+/** @brief Awaiter of a nested graph */
+class Flow::Coroutine::GraphAwaiter
+{
+public:
+    /** @brief Construct the awaiter */
+    GraphAwaiter(Graph &graph, Node * const node) noexcept : _graph(graph), _node(node) {}
+
+    /** @brief Awaiter interface */
+    [[nodiscard]] bool await_ready(void) const noexcept;
+    void await_suspend(const std::coroutine_handle<> handle) const;
+    void await_resume(void) const;
+
+private:
+    Graph &_graph;
+    Node *_node;
+};
+
+/** @brief Coroutine frame resuming a coroutine node once resumed itself, used as the handle given to user awaiters */
+class Flow::CoroutineResumer
+{
+public:
+    struct promise_type
+    {
+        Node *node;
+
+        /** @brief Construct the promise from the coroutine arguments */
+        promise_type(Node * const resumed) noexcept : node(resumed) {}
+
+        /** @brief Once resumed, the frame is destroyed and the node dispatched again */
+        struct FinalAwaiter
+        {
+            [[nodiscard]] bool await_ready(void) const noexcept { return false; }
+            void await_suspend(const std::coroutine_handle<promise_type> handle) const noexcept
+            {
+                const auto node = handle.promise().node;
+                handle.destroy();
+                ResumeCoroutine(node);
+            }
+            void await_resume(void) const noexcept {}
+        };
+
+        [[nodiscard]] CoroutineResumer get_return_object(void) noexcept
+            { return CoroutineResumer(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        [[nodiscard]] std::suspend_always initial_suspend(void) const noexcept { return {}; }
+        [[nodiscard]] FinalAwaiter final_suspend(void) const noexcept { return {}; }
+        void return_void(void) const noexcept {}
+        void unhandled_exception(void) const noexcept { std::terminate(); }
+    };
+
+    /** @brief Create the resumer of a node */
+    [[nodiscard]] static CoroutineResumer Create([[maybe_unused]] Node * const node) { co_return; }
+
+    /** @brief Get the handle of the resumer frame */
+    [[nodiscard]] std::coroutine_handle<> handle(void) const noexcept { return _handle; }
+
+private:
+    std::coroutine_handle<promise_type> _handle {};
+
+    /** @brief Construct from a handle */
+    explicit CoroutineResumer(const std::coroutine_handle<promise_type> handle) noexcept : _handle(handle) {}
+};
+
+/** @brief Awaiter wrapping a user awaiter
+ *  The user awaiter receives the handle of a resumer frame, so the coroutine continues on a worker whatever the resuming thread */
+template<typename Awaiter>
+class Flow::Coroutine::ExternalAwaiter
+{
+public:
+    /** @brief Construct the awaiter */
+    template<typename Forward>
+    ExternalAwaiter(Forward &&awaiter, Node * const node) noexcept(std::is_nothrow_constructible_v<Awaiter, Forward>)
+        : _awaiter(std::forward<Forward>(awaiter)), _node(node) {}
+
+    /** @brief Awaiter interface */
+    [[nodiscard]] bool await_ready(void) { return _awaiter.await_ready(); }
+    [[nodiscard]] bool await_suspend(const std::coroutine_handle<> handle);
+    decltype(auto) await_resume(void) { return _awaiter.await_resume(); }
+
+private:
+    Awaiter _awaiter;
+    Node *_node;
+};
@@ -0,0 +1,53 @@
+/**
+ * @ Author: Matthieu Moinvaziri
+ * @ Description: Coroutine node
+ */
+
+inline void Flow::ResumeCoroutine(Node * const node) noexcept
+{
+    node->root->scheduler()->spawn(Task(node));
+}
+
+inline Flow::Coroutine::GraphAwaiter Flow::Coroutine::promise_type::await_transform(Graph &graph) const noexcept
+{
+    return GraphAwaiter(graph, _node);
+}
+
+inline bool Flow::Coroutine::GraphAwaiter::await_ready(void) const noexcept
+{
+    return !_graph || !_graph.size();
+}
+
+inline void Flow::Coroutine::GraphAwaiter::await_suspend(const std::coroutine_handle<>) const
+{
+    const auto root = _node->root;
+
+    // The coroutine is resumed by the worker completing the run, possibly before this function returns
+    _graph.setParentNode(_node, Deadline(), false);
+    root->scheduler()->schedule(_graph, root->deadline());
+}
+
+inline void Flow::Coroutine::GraphAwaiter::await_resume(void) const
+{
+    if (const auto exception = _graph.exception(); exception)
+        std::rethrow_exception(exception);
+}
+
+template<typename Awaiter>
+inline bool Flow::Coroutine::ExternalAwaiter<Awaiter>::await_suspend(const std::coroutine_handle<>)
+{
+    using Result = decltype(_awaiter.await_suspend(std::declval<std::coroutine_handle<>>()));
+
+    static_assert(std::is_void_v<Result> || std::is_same_v<Result, bool>,
+        "Flow::Coroutine::ExternalAwaiter: Awaiter's 'await_suspend' must return void or bool");
+    const auto resumer = CoroutineResumer::Create(_node).handle();
+    if constexpr (std::is_void_v<Result>) {
+        _awaiter.await_suspend(resumer);
+        return true;
+    } else {
+        if (_awaiter.await_suspend(resumer))
+            return true;
+        resumer.destroy();
+        return false;
+    }
+}
@@ -7,24 +7,50 @@ include(${FlowDir}/External/External.cmake)
 project(Flow)
 
 set(FlowPrecompiledHeaders
+    ${FlowDir}/Algorithms.hpp
+    ${FlowDir}/CompiledGraph.hpp
+    ${FlowDir}/Coroutine.hpp
+    ${FlowDir}/Future.hpp
     ${FlowDir}/Graph.hpp
     ${FlowDir}/Node.hpp
+    ${FlowDir}/NodeArena.hpp
     ${FlowDir}/NodeType.hpp
+    ${FlowDir}/NotificationQueue.hpp
+    ${FlowDir}/Pipeline.hpp
     ${FlowDir}/Scheduler.hpp
+    ${FlowDir}/StaticGraph.hpp
+    ${FlowDir}/Stats.hpp
     ${FlowDir}/Task.hpp
+    ${FlowDir}/Topology.hpp
+    ${FlowDir}/Trace.hpp
     ${FlowDir}/Worker.hpp
+    ${FlowDir}/WorkStealingDeque.hpp
     ${FlowDir}/AtomicWait.hpp
+    ${FlowDir}/Backoff.hpp
 )
 
 set(FlowSources
     ${FlowPrecompiledHeaders}
+    ${FlowDir}/Algorithms.ipp
+    ${FlowDir}/CompiledGraph.cpp
+    ${FlowDir}/Coroutine.ipp
     ${FlowDir}/Graph.ipp
     ${FlowDir}/Graph.cpp
+    ${FlowDir}/NodeArena.ipp
+    ${FlowDir}/NotificationQueue.cpp
+    ${FlowDir}/NotificationQueue.ipp
+    ${FlowDir}/Pipeline.ipp
     ${FlowDir}/Scheduler.cpp
     ${FlowDir}/Scheduler.ipp
+    ${FlowDir}/StaticGraph.ipp
+    ${FlowDir}/Stats.cpp
     ${FlowDir}/Task.ipp
+    ${FlowDir}/Topology.cpp
+    ${FlowDir}/Trace.cpp
+    ${FlowDir}/Trace.ipp
     ${FlowDir}/Worker.cpp
     ${FlowDir}/Worker.ipp
+    ${FlowDir}/WorkStealingDeque.ipp
 )
 
 add_library(${PROJECT_NAME} ${FlowSources})
@@ -38,6 +64,10 @@ target_include_directories(${PROJECT_NAME} PUBLIC ${FlowDir}/..)
 
 target_link_libraries(${PROJECT_NAME} PUBLIC Core AtomicWait)
 
+if(FLOW_DISABLE_TRACING)
+    target_compile_definitions(${PROJECT_NAME} PUBLIC FLOW_DISABLE_TRACING)
+endif()
+
 if(CODE_COVERAGE)
     target_compile_options(${PROJECT_NAME} PUBLIC --coverage)
     target_link_options(${PROJECT_NAME} PUBLIC --coverage)
@@ -0,0 +1,68 @@
+/**
+ * @ Author: Matthieu Moinvaziri
+ * @ Description: Future of a scheduled graph
+ */
+
+#pragma once
+
+// This header must no be directly included, include 'Scheduler' instead
+
+#include "Graph.hpp"
+
+namespace Flow
+{
+    class Future;
+}
+
+/** @brief Lightweight future returned when a graph is scheduled
+ *  It shares the graph data and becomes ready as soon as the scheduled run is completed */
+class Flow::Future
+{
+public:
+    /** @brief Default constructor (invalid future) */
+    Future(void) noexcept = default;
+
+    /** @brief Construct a future of a graph run, given the run state returned by Graph::startRun */
+    Future(const Graph &graph, const std::uint32_t runState) noexcept : _graph(graph), _runState(runState) {}
+
+    /** @brief Fast check */
+    [[nodiscard]] bool valid(void) const noexcept { return _graph; }
+
+    /** @brief Check if the run is completed (an invalid future is always ready) */
+    [[nodiscard]] bool ready(void) const noexcept { return !_graph || _graph.runState() != _runState; }
+
+    /** @brief Block the current thread until the run is completed
+     *  If a node of the run threw, its exception is rethrown */
+    void wait(void) const;
+
+    /** @brief Cancel the run, see Graph::cancel
+     *  Only the run of this future is cancelled, a later run of the graph is left untouched */
+    void cancel(void) noexcept { if (_graph) _graph.cancelRun(_runState); }
+
+    /** @brief Block the current thread until the run is completed or the timeout is reached, returns false on timeout */
+    template<typename Rep, typename Period>
+    [[nodiscard]] bool waitFor(const std::chrono::duration<Rep, Period> &duration) const noexcept
+        { return waitUntil(std::chrono::steady_clock::now() + duration); }
+
+    template<typename Clock, typename Duration>
+    [[nodiscard]] bool waitUntil(const std::chrono::time_point<Clock, Duration> &timeout) const noexcept;
+
+private:
+    Graph _graph {};
+    std::uint32_t _runState { 0u };
+};
+
+inline void Flow::Future::wait(void) const
+{
+    if (_graph) {
+        _graph.waitRunState(_runState);
+        if (const auto exception = _graph.exception(); exception)
+            std::rethrow_exception(exception);
+    }
+}
+
+template<typename Clock, typename Duration>
+inline bool Flow::Future::waitUntil(const std::chrono::time_point<Clock, Duration> &timeout) const noexcept
+{
+    return !_graph || _graph.waitRunStateUntil(_runState, timeout);
+}
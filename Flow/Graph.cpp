@@ -3,47 +3,258 @@
  * @ Description: Graph
  */
 
+#include <algorithm>
+
 #include "Scheduler.hpp"
 
 void Flow::Graph::childrenJoined(const std::uint32_t childrenJoined) noexcept
 {
     if (const auto count = _data->children.size(); (_data->joined += childrenJoined) == count) {
         _data->joined = 0;
-        if (hasRepeatCallback() && _data->repeatCallback())
-            _data->scheduler->schedule<true>(*this);
-        else {
-            setRunning(false);
-            setScheduler(nullptr);
+        if (!cancelled() && hasRepeatCallback() && _data->repeatCallback()) {
+            if (hasDeadline())
+                renewDeadline();
+            _data->scheduler->repeat(*this);
+            return;
+        }
+        // Once the run is completed, a waiting thread may release the data: only its address can be used afterward
+        const auto data = _data;
+        const auto scheduler = data->scheduler;
+        const auto parentNode = data->parentNode;
+        const auto parentStart = data->parentStart;
+        const auto parentStolen = data->parentStolen;
+        auto callback = std::move(data->completeCallback);
+        // A coroutine rethrows the exception of its awaited graph itself
+        const auto awaited = parentNode && parentNode->workData.index() == static_cast<std::size_t>(NodeType::Coroutine);
+        if (parentNode) {
+            if (!awaited && data->exception)
+                parentNode->root->fail(data->exception);
+            data->parentNode = nullptr;
+        }
+        if (data->deadline != NoDeadline) {
+            data->deadline = NoDeadline;
+            scheduler->deadlineCompleted();
         }
+        data->scheduler = nullptr;
+        // Clear the running bit and increment the completed runs count at once
+        data->runState.fetch_add(RunningBit, std::memory_order_seq_cst);
+        atomic_sync::atomic_notify_all(&data->runState);
+        if (callback)
+            callback();
+        // The suspended node belongs to the parent run, which can't complete before the node is resumed
+        if (awaited)
+            ResumeCoroutine(parentNode);
+        else if (parentNode)
+            Worker::Current()->resumeNode(parentNode, parentStart, parentStolen);
+        scheduler->graphCompleted();
     }
 }
 
+bool Flow::Graph::IsFusable(const Node &node) noexcept
+{
+    constexpr auto Static = static_cast<std::size_t>(NodeType::Static);
+
+    return node.workData.index() == Static && node.linkedTo.size() == 1ul
+        && node.linkedTo[0]->workData.index() == Static && node.linkedTo[0]->linkedFrom.size() == 1ul;
+}
+
 void Flow::Graph::preprocessImpl(void) noexcept
 {
-    Core::TinyVector<const Node *> cache;
+    const auto count = static_cast<std::uint32_t>(size());
+    std::uint32_t rootCount { 0u };
 
+    // Node indexes are only used as scratch while preprocessing, compile assigns them again
+    for (std::uint32_t index = 0u; index != count; ++index) {
+        const auto node = _data->children[index].node();
+        node->index = index;
+        rootCount += node->linkedFrom.empty();
+    }
+    _data->roots.clear();
+    _data->roots.reserve(rootCount);
     for (auto &node : *this) {
-        if (node->workData.index() != static_cast<std::size_t>(Node::WorkType::Switch))
-            continue;
-        auto &switchTask = std::get<static_cast<std::size_t>(Node::WorkType::Switch)>(node->workData);
+        if (node->linkedFrom.empty())
+            _data->roots.push(Task(node.node()));
+        node->fused = _data->chainFusion && !_data->selfJoined && IsFusable(*node.node());
+    }
+    if (_data->recountSwitches || !_data->linkSources.empty())
+        countSwitches(_data->recountSwitches);
+    _data->recountSwitches = false;
+    _data->linkSources.clear();
+    computePriorities();
+    _data->isPreprocessed = true;
+}
+
+void Flow::Graph::countSwitches(const bool all) noexcept
+{
+    constexpr auto Switch = static_cast<std::size_t>(NodeType::Switch);
+    const auto count = static_cast<std::uint32_t>(size());
+    Core::HeapArray<std::uint32_t> marks;
+    Core::HeapArray<Node *> stack;
+    Core::FlatVector<Node *> switches;
+    std::uint32_t epoch { 0u };
+    std::uint32_t stackSize { 0u };
+
+    // Each walk stamps the nodes it visits with its own epoch so marks never need to be cleared, a node is pushed once per walk
+    marks.allocate(count, 0u);
+    stack.allocate(count);
+    const auto push = [&marks, &stack, &stackSize, &epoch](Node * const node) {
+        if (marks[node->index] != epoch) {
+            marks[node->index] = epoch;
+            stack[stackSize++] = node;
+        }
+    };
+
+    // A new link only changes the nodes reached by the switch nodes reaching its source: walk the predecessors of every source at once
+    ++epoch;
+    if (!all) {
+        for (const auto source : _data->linkSources)
+            push(source);
+        while (stackSize) {
+            const auto node = stack[--stackSize];
+            if (node->workData.index() == Switch)
+                switches.push(node);
+            for (const auto link : node->linkedFrom)
+                push(link);
+        }
+    } else {
+        for (auto &child : *this) {
+            if (child->workData.index() == Switch)
+                switches.push(child.node());
+        }
+    }
+    for (const auto node : switches) {
+        auto &switchTask = std::get<Switch>(node->workData);
+        switchTask.joinCounts.clear();
         switchTask.joinCounts.reserve(node->linkedTo.size());
-        for (const auto childNode : node->linkedTo) {
-            std::uint32_t count { 1u };
-            cache.clear();
-            countSubChildren(*childNode, count, cache);
-            switchTask.joinCounts.push(count);
+        // A branch is joined with every node it reaches
+        for (const auto branch : node->linkedTo) {
+            std::uint32_t joinCount { 0u };
+            ++epoch;
+            push(branch);
+            while (stackSize) {
+                ++joinCount;
+                for (const auto link : stack[--stackSize]->linkedTo)
+                    push(link);
+            }
+            switchTask.joinCounts.push(joinCount);
         }
     }
-    _data->isPreprocessed = true;
 }
 
-void Flow::Graph::countSubChildren(const Node &node, std::uint32_t &count, Core::TinyVector<const Node *> &cache) noexcept
+void Flow::Graph::computePriorities(void) noexcept
 {
-    for (const auto childNode : node.linkedTo) {
-        if (cache.find(childNode) == cache.end()) {
-            ++count;
-            cache.push(childNode);
-            countSubChildren(*childNode, count, cache);
+    auto &children = _data->children;
+    const auto count = static_cast<std::uint32_t>(size());
+    Core::HeapArray<std::uint32_t> order;
+    Core::HeapArray<std::uint32_t> depths;
+    Core::HeapArray<std::uint32_t> remainings;
+    std::uint32_t orderSize { 0u };
+    std::uint32_t longest { 0u };
+
+    order.allocate(count);
+    depths.allocate(count, 0u);
+    remainings.allocate(count, 0u);
+    for (std::uint32_t index = 0u; index != count; ++index) {
+        if (children[index]->linkedFrom.empty())
+            order[orderSize++] = index;
+        else
+            depths[index] = static_cast<std::uint32_t>(children[index]->linkedFrom.size());
+    }
+    // Topological order, 'depths' holds the pending predecessors of each node until it is ordered
+    for (std::uint32_t i = 0u; i != orderSize; ++i) {
+        for (const auto link : children[order[i]]->linkedTo) {
+            if (!--depths[link->index])
+                order[orderSize++] = link->index;
+        }
+    }
+    // Longest chains from a source (depth) and to a sink (remaining) through each node, counted in nodes
+    for (std::uint32_t i = 0u; i != orderSize; ++i) {
+        const auto index = order[i];
+        for (const auto link : children[index]->linkedFrom)
+            depths[index] = std::max(depths[index], depths[link->index]);
+        ++depths[index];
+    }
+    for (auto i = orderSize; i; --i) {
+        const auto index = order[i - 1u];
+        for (const auto link : children[index]->linkedTo)
+            remainings[index] = std::max(remainings[index], remainings[link->index]);
+        longest = std::max(longest, ++remainings[index]);
+    }
+    // Nodes without slack lie on a critical path: delaying any of them delays the whole run
+    for (std::uint32_t index = 0u; index != count; ++index) {
+        const auto node = children[index].node();
+        if (node->priority != Priority::Auto)
+            node->level = node->priority;
+        else if (depths[index] + remainings[index] == longest + 1u)
+            node->level = Priority::High;
+        else
+            node->level = Priority::Normal;
+    }
+}
+
+void Flow::Graph::compile(const ScheduleMode mode)
+{
+    construct();
+    if (running())
+        throw std::logic_error("Flow::Graph::compile: Can't compile a graph while it is running");
+    preprocess();
+    // Compiled successors would be joined by workers on top of the nodes themselves
+    if (_data->selfJoined)
+        return;
+    if (!_data->compiled)
+        compileImpl();
+    auto &compiled = *_data->compiled;
+    const bool hasSwitch = compiled.typeOffsets[static_cast<std::size_t>(NodeType::Switch)] != compiled.typeOffsets[static_cast<std::size_t>(NodeType::Switch) + 1ul];
+    if (mode == ScheduleMode::Dynamic || hasSwitch)
+        compiled.staticSchedule.reset();
+    else if (!compiled.staticSchedule)
+        compiled.allocateStaticSchedule();
+}
+
+void Flow::Graph::compileImpl(void)
+{
+    auto compiled = std::make_unique<CompiledGraph>();
+    const auto count = static_cast<std::uint32_t>(size());
+    std::uint32_t edgeCount { 0u };
+
+    // Count nodes of each type to group them by type
+    for (auto &node : *this) {
+        ++compiled->typeOffsets[node->workData.index() + 1ul];
+        edgeCount += static_cast<std::uint32_t>(node->linkedTo.size());
+    }
+    for (auto i = 1ul; i <= CompiledGraph::TypeCount; ++i)
+        compiled->typeOffsets[i] += compiled->typeOffsets[i - 1ul];
+
+    // Assign node indexes
+    std::uint32_t cursors[CompiledGraph::TypeCount];
+    std::copy_n(compiled->typeOffsets, CompiledGraph::TypeCount, cursors);
+    compiled->nodes.allocate(count);
+    compiled->staticWorks.allocate(compiled->staticCount());
+    for (auto &node : *this) {
+        const auto index = cursors[node->workData.index()]++;
+        node->index = index;
+        compiled->nodes[index] = node.node();
+        if (index < compiled->staticCount())
+            compiled->staticWorks[index] = std::move(std::get<static_cast<std::size_t>(NodeType::Static)>(node->workData));
+        else if (node->workData.index() == static_cast<std::size_t>(NodeType::Graph)) {
+            if (auto &graph = std::get<static_cast<std::size_t>(NodeType::Graph)>(node->workData); graph)
+                graph.compile();
         }
     }
-}
\ No newline at end of file
+
+    // Build successor lists in CSR form, keeping the link order required by switch nodes
+    compiled->successorOffsets.allocate(count + 1u);
+    compiled->successors.allocate(edgeCount);
+    compiled->joinCounts.allocate(count);
+    compiled->joined.allocate(count);
+    std::uint32_t edge { 0u };
+    for (std::uint32_t index = 0u; index != count; ++index) {
+        const auto node = compiled->nodes[index];
+        compiled->successorOffsets[index] = edge;
+        for (const auto link : node->linkedTo)
+            compiled->successors[edge++] = link->index;
+        compiled->joinCounts[index] = static_cast<std::uint32_t>(node->linkedFrom.size());
+    }
+    compiled->successorOffsets[count] = edge;
+    _data->compiled = std::move(compiled);
+}
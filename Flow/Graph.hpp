@@ -8,11 +8,17 @@
 #include <thread>
 #include <memory>
 #include <atomic>
+#include <chrono>
+#include <exception>
 
 #include <Core/PMR.hpp>
 #include <Core/Assert.hpp>
 #include <Core/Vector.hpp>
+#include <Core/FlatVector.hpp>
 
+#include "AtomicWait.hpp"
+#include "CompiledGraph.hpp"
+#include "NodeArena.hpp"
 #include "Task.hpp"
 
 namespace Flow
@@ -21,6 +27,21 @@ namespace Flow
     class Graph;
 
     class Scheduler;
+
+    /** @brief Clock used to express graph deadlines */
+    using DeadlineClock = std::chrono::steady_clock;
+
+    /** @brief Deadline of a graph run */
+    using Deadline = DeadlineClock::time_point;
+
+    /** @brief Deadline value of a graph without any time constraint */
+    constexpr Deadline NoDeadline = Deadline::max();
+
+    /** @brief Placement of the nodes of a compiled graph */
+    enum class ScheduleMode {
+        Dynamic,    // Ready nodes are executed where they become ready and balanced by stealing
+        Static      // Nodes are replayed on the worker lanes planned from the costs measured on previous runs
+    };
 }
 
 class alignas_eighth_cacheline Flow::Graph
@@ -29,16 +50,33 @@ public:
     /** @brief Data of the task graph */
     struct alignas_cacheline Data
     {
-        Core::TinyVector<NodeInstance> children; // Children instances
+        NodeArena arena; // Memory of the children, must outlive their instances
+        Core::TinyVector<NodeInstance> children {}; // Children instances
         std::atomic<std::uint32_t> joined { 0 }; // Number of joined nodes
+        std::atomic<std::uint32_t> runState { 0 }; // Bit 0 is set while the graph is processing, other bits count completed runs
+        std::atomic<std::uint32_t> cancelledRun { 0 }; // Run state of the last cancelled or failed run, its remaining nodes are drained
         std::atomic<std::uint16_t> sharedCount { 1 }; // Number of shared graph instances
-        std::atomic<bool> running { false }; // True if the graph is already processing
         bool isPreprocessed { false }; // True if the graph is already preprocessed and safe to schedule
+        std::atomic<bool> deadlineMissed { false }; // True if the current run missed its deadline
+        std::atomic<bool> failed { false }; // True if a node of the current run threw
+        bool chainFusion { false }; // True if chains of static nodes are fused on preprocess
+        bool recountSwitches { false }; // True if every switch join count must be recomputed on preprocess
+        bool parentStolen { false }; // True if the suspended node was stolen by the worker that dispatched it
+        bool selfJoined { false }; // True if nodes join their successors from their own work, workers only join the nodes themselves
         Scheduler *scheduler { nullptr }; // The scheduler that ran the graph
+        Node *parentNode { nullptr }; // Node suspended on the current run, if scheduled as a nested graph
+        Deadline parentStart {}; // Dispatch time of the suspended node, traced and costed once it resumes (null if not timed)
+        std::unique_ptr<CompiledGraph> compiled {}; // Frozen topology, null until compiled or once the topology changed
+        std::exception_ptr exception {}; // First exception thrown by a node of the last run
         Core::Functor<bool(void)> repeatCallback {}; // On true returned, it will immediatly repeat the graph after it succeeded
+        Core::Functor<void(void)> completeCallback {}; // Called once when the current run is completed
+        Deadline deadline { NoDeadline }; // Deadline of the current run
+        DeadlineClock::duration deadlineBudget {}; // Time given to each run from its start, a repeated run gets its own deadline
+        Core::FlatVector<Task> roots {}; // Nodes without predecessor, computed on preprocess
+        Core::FlatVector<Node *> linkSources {}; // Sources of the links added since the last preprocess
     };
 
-    static_assert_fit_cacheline(Data);
+    static_assert_sizeof(Data, 3 * Core::CacheLineSize);
 
     /** @brief Shared pointer to data structure */
     using DataPtr = std::shared_ptr<Data>;
@@ -50,6 +88,9 @@ public:
     /** @brief Default construtor */
     Graph(void) noexcept = default;
 
+    /** @brief Construct the graph using a memory resource for its data and nodes */
+    explicit Graph(std::pmr::memory_resource * const resource) noexcept { construct(resource); }
+
     /** @brief Copy constructor */
     Graph(const Graph &other) noexcept { acquire(other); }
 
@@ -79,11 +120,12 @@ public:
     void release(void);
 
     /** @brief Construct an instance if not already done */
-    void construct(void) noexcept;
+    void construct(void) noexcept { construct(std::pmr::get_default_resource()); }
+    void construct(std::pmr::memory_resource * const resource) noexcept;
 
 
     /** @brief Get the running property */
-    [[nodiscard]] bool running(void) const noexcept { return _data->running.load(std::memory_order_seq_cst); }
+    [[nodiscard]] bool running(void) const noexcept { return runState() & RunningBit; }
 
 
     /** @brief Check if the graph has a repeat callback */
@@ -100,8 +142,29 @@ public:
     Task emplace(Args &&...args);
 
 
-    /** @brief Wait for the graph to be executed */
-    void wait(void) noexcept_ndebug;
+    /** @brief Block the current thread until the graph is executed
+     *  If a node of the run threw, its exception is rethrown */
+    void wait(void) const;
+
+    /** @brief Block the current thread until the graph is executed or the timeout is reached, returns false on timeout */
+    template<typename Rep, typename Period>
+    [[nodiscard]] bool waitFor(const std::chrono::duration<Rep, Period> &duration) const noexcept
+        { return waitUntil(std::chrono::steady_clock::now() + duration); }
+
+    template<typename Clock, typename Duration>
+    [[nodiscard]] bool waitUntil(const std::chrono::time_point<Clock, Duration> &timeout) const noexcept;
+
+
+    /** @brief Cancel the current run: nodes not yet started are counted as joined without executing their work
+     *  Cancellation is cooperative, running nodes may poll 'cancelled' to stop early */
+    void cancel(void) noexcept { if (_data) cancelRun(runState()); }
+
+    /** @brief Check if the current run is cancelled or failed, a nested run is also cancelled with its parent run */
+    [[nodiscard]] bool cancelled(void) const noexcept;
+
+    /** @brief Get the first exception thrown by a node of the last run, null if none
+     *  Only safe to call once the run is completed */
+    [[nodiscard]] std::exception_ptr exception(void) const noexcept { return _data ? _data->exception : nullptr; }
 
 
     /** @brief Clear every node link (node are still valid) */
@@ -113,6 +176,29 @@ public:
     /** @brief Ensure that the graph is ready to be scheduled (called by the Scheduler on schedule) */
     void preprocess(void) noexcept;
 
+    /** @brief Preprocess the graph and freeze its topology into a compiled form used by workers on every run
+     *  Nested graph nodes are compiled too, any later change of the topology drops the compiled form
+     *  The static schedule mode is ignored by graphs containing switch nodes, self joined graphs are never compiled */
+    void compile(const ScheduleMode mode = ScheduleMode::Dynamic);
+
+    /** @brief Enable / disable the fusion of static node chains, applied on the next preprocess
+     *  A static node whose single successor is a static node with a single predecessor executes it right after itself,
+     *  without joining the successor nor the graph for each link, name, notification and bypass still apply per node
+     *  Fusion is ignored by the static schedule mode which places each node on its own lane */
+    void setChainFusion(const bool fuse) noexcept { construct(); _data->chainFusion = fuse; invalidateIncrementally(); }
+
+    /** @brief Check if chain fusion is enabled */
+    [[nodiscard]] bool chainFusion(void) const noexcept { return _data && _data->chainFusion; }
+
+    /** @brief Check if the graph is compiled */
+    [[nodiscard]] bool isCompiled(void) const noexcept { return _data && _data->compiled; }
+
+    /** @brief Get / Set the self joined property, nodes keep their links but join their successors from their own work
+     *  Such nodes are never fused and their drained runs still execute their work, which must skip itself on a cancelled run
+     *  Reserved for internal use ! */
+    [[nodiscard]] bool selfJoined(void) const noexcept { return _data->selfJoined; }
+    void setSelfJoined(void) noexcept { construct(); _data->selfJoined = true; invalidateIncrementally(); }
+
 
     /** @brief Get the number of owned nodes */
     [[nodiscard]] auto size(void) const noexcept { return _data->children.size(); }
@@ -124,9 +210,42 @@ public:
     [[nodiscard]] ConstIterator end(void) const noexcept { return _data->children.end(); }
 
 public:
-    /** @brief Set the running property
+    /** @brief Running bit of the run state */
+    static constexpr std::uint32_t RunningBit { 1u };
+
+    /** @brief Get the run state, it changes each time a run starts or completes
+     *  Reserved for internal use ! */
+    [[nodiscard]] std::uint32_t runState(void) const noexcept { return _data->runState.load(std::memory_order_seq_cst); }
+
+    /** @brief Reset the cancellation state and set the running bit, returns the run state of the started run
+     *  Reserved for internal use ! */
+    std::uint32_t startRun(void) noexcept;
+
+    /** @brief Block until the current run is completed, without rethrowing its exception
+     *  Reserved for internal use ! */
+    void waitCompletion(void) const noexcept;
+
+    /** @brief Set the node suspended on the current run, its dispatch time and whether it was stolen
+     *  The node is resumed by the worker completing the run, before the graph may be released
+     *  Reserved for internal use ! */
+    void setParentNode(Node * const node, const Deadline start, const bool stolen) noexcept
+        { _data->parentNode = node; _data->parentStart = start; _data->parentStolen = stolen; }
+
+    /** @brief Cancel the run identified by 'state' (as returned by startRun), nothing happens if it is already completed
+     *  Reserved for internal use ! */
+    void cancelRun(const std::uint32_t state) noexcept;
+
+    /** @brief Capture the exception of a failed node and cancel the run, only the first exception is kept
+     *  Reserved for internal use ! */
+    void fail(std::exception_ptr exception) noexcept;
+
+    /** @brief Block until the run state differs from 'state'
      *  Reserved for internal use ! */
-    void setRunning(const bool running) noexcept { _data->running.store(running, std::memory_order_seq_cst); }
+    void waitRunState(const std::uint32_t state) const noexcept;
+
+    template<typename Clock, typename Duration>
+    [[nodiscard]] bool waitRunStateUntil(const std::uint32_t state, const std::chrono::time_point<Clock, Duration> &timeout) const noexcept
+        { return AtomicWaitUntil(_data->runState, state, timeout); }
 
     /** @brief Get the joined property
      *  Reserved for internal use ! */
@@ -137,24 +256,89 @@ public:
     void childJoined(void) noexcept { childrenJoined(1); }
     void childrenJoined(const std::uint32_t childrenJoined) noexcept;
 
+    /** @brief Account for a child scheduled once more during the current run, so that its extra execution can be joined as any other one
+     *  Must be called by a running child, before scheduling
+     *  Reserved for internal use ! */
+    void childScheduled(void) noexcept { _data->joined.fetch_sub(1u); }
+
+    /** @brief Get the root tasks of a preprocessed graph
+     *  Reserved for internal use ! */
+    [[nodiscard]] const Core::FlatVector<Task> &roots(void) const noexcept { return _data->roots; }
+
+    /** @brief Get the compiled form of the graph, null if not compiled
+     *  Reserved for internal use ! */
+    [[nodiscard]] CompiledGraph *compiled(void) const noexcept { return _data->compiled.get(); }
+
+    /** @brief Drop the preprocessed and compiled states after a topology change, every switch join count is recomputed
+     *  Reserved for internal use ! */
+    void invalidate(void) noexcept;
+
+    /** @brief Drop the preprocessed and compiled states after nodes were added, or a link was added from 'linkSource'
+     *  Only the switch nodes reaching a new link are recounted on the next preprocess
+     *  Reserved for internal use ! */
+    void invalidateIncrementally(Node * const linkSource = nullptr) noexcept;
+
+    /** @brief Get the scheduler running the graph, null if not running
+     *  Reserved for internal use ! */
+    [[nodiscard]] Scheduler *scheduler(void) const noexcept { return _data->scheduler; }
+
     /** @brief Set the scheduler property
      *  Reserved for internal use ! */
     void setScheduler(Scheduler * const scheduler) noexcept { _data->scheduler = scheduler; }
 
+    /** @brief Set the callback called once when the current run is completed
+     *  Reserved for internal use ! */
+    template<typename Callback>
+    void setCompleteCallback(Callback &&callback) noexcept { _data->completeCallback = std::forward<Callback>(callback); }
+
+    /** @brief Get / Set the deadline of the current run, the time left until it is the budget of every repeat
+     *  Reserved for internal use ! */
+    [[nodiscard]] Deadline deadline(void) const noexcept { return _data->deadline; }
+    void setDeadline(const Deadline deadline) noexcept;
+
+    /** @brief Give the repeated run a new deadline, its budget counted from now
+     *  Reserved for internal use ! */
+    void renewDeadline(void) noexcept;
+
+    /** @brief Check if the current run has a deadline
+     *  Reserved for internal use ! */
+    [[nodiscard]] bool hasDeadline(void) const noexcept { return _data->deadline != NoDeadline; }
+
+    /** @brief Check if the current run missed its deadline
+     *  Reserved for internal use ! */
+    [[nodiscard]] bool deadlineMissed(void) const noexcept { return _data->deadlineMissed.load(std::memory_order_relaxed); }
+
+    /** @brief Mark the current run as late, returns true only for the first caller
+     *  Reserved for internal use ! */
+    [[nodiscard]] bool markDeadlineMissed(void) noexcept
+        { return !_data->deadlineMissed.load(std::memory_order_relaxed) && !_data->deadlineMissed.exchange(true, std::memory_order_relaxed); }
+
+
 private:
     Data *_data { nullptr };
 
-    inline static std::pmr::synchronized_pool_resource _Pool {};
-
     /** @brief Implementation of the preprocess algorithm */
     void preprocessImpl(void) noexcept;
 
-    /** @brief Count the numbr of ssubchildren of a node */
-    void countSubChildren(const Node &node, std::uint32_t &count, Core::TinyVector<const Node *> &cache) noexcept;
+    /** @brief Check if a node can be fused with its successor */
+    [[nodiscard]] static bool IsFusable(const Node &node) noexcept;
+
+    /** @brief Compute the effective priority of nodes with an automatic priority from the critical paths of the graph */
+    void computePriorities(void) noexcept;
+
+    /** @brief Implementation of the compile algorithm */
+    void compileImpl(void);
+
+    /** @brief Drop the compiled form, moving the work functors of static nodes back into their nodes */
+    void dropCompiled(void) noexcept;
+
+    /** @brief Recompute the join counts of every switch node, or only of those reaching a link source when 'all' is false */
+    void countSwitches(const bool all) noexcept;
 };
 
 static_assert_fit_eighth_cacheline(Flow::Graph);
 
 #include "Node.hpp" // Include the node to compile Task.ipp and Graph.ipp
+#include "NodeArena.ipp"
 #include "Task.ipp"
 #include "Graph.ipp"
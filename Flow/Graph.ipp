@@ -14,32 +14,125 @@ inline void Flow::Graph::acquire(const Graph &other) noexcept
 inline void Flow::Graph::release(void)
 {
     if (_data && --_data->sharedCount == 0u) {
-        wait();
+        waitCompletion();
+        const auto resource = _data->arena.resource();
         _data->~Data();
-        _Pool.deallocate(_data, sizeof(Data), alignof(Data));
+        resource->deallocate(_data, sizeof(Data), alignof(Data));
     }
 }
 
-inline void Flow::Graph::construct(void) noexcept
+inline void Flow::Graph::construct(std::pmr::memory_resource * const resource) noexcept
 {
     if (!_data)
-        _data = new (_Pool.allocate(sizeof(Data), alignof(Data))) Data {};
+        _data = new (resource->allocate(sizeof(Data), alignof(Data))) Data { NodeArena(resource) };
 }
 
 template<typename ...Args>
 inline Flow::Task Flow::Graph::emplace(Args &&...args)
 {
     construct();
-    const auto node = _data->children.push(std::forward<Args>(args)...).node();
+    const auto node = _data->children.push(_data->arena.allocate(std::forward<Args>(args)...)).node();
     node->root = this;
-    _data->isPreprocessed = false;
+    invalidateIncrementally();
     return Task(node);
 }
 
-inline void Flow::Graph::wait(void) noexcept_ndebug
+inline void Flow::Graph::invalidate(void) noexcept
+{
+    _data->isPreprocessed = false;
+    _data->recountSwitches = true;
+    _data->linkSources.clear();
+    dropCompiled();
+}
+
+inline void Flow::Graph::invalidateIncrementally(Node * const linkSource) noexcept
+{
+    _data->isPreprocessed = false;
+    if (linkSource && !_data->recountSwitches)
+        _data->linkSources.push(linkSource);
+    dropCompiled();
+}
+
+inline void Flow::Graph::dropCompiled(void) noexcept
+{
+    if (const auto compiled = _data->compiled.get(); compiled) {
+        for (std::uint32_t index = 0u; index != compiled->staticCount(); ++index)
+            std::get<static_cast<std::size_t>(NodeType::Static)>(compiled->nodes[index]->workData) = std::move(compiled->staticWorks[index]);
+        _data->compiled.reset();
+    }
+}
+
+inline void Flow::Graph::wait(void) const
+{
+    waitCompletion();
+    if (_data && _data->exception)
+        std::rethrow_exception(_data->exception);
+}
+
+inline void Flow::Graph::waitCompletion(void) const noexcept
+{
+    for (auto state = runState(); state & RunningBit; state = runState())
+        waitRunState(state);
+}
+
+inline std::uint32_t Flow::Graph::startRun(void) noexcept
+{
+    _data->failed.store(false, std::memory_order_relaxed);
+    _data->exception = nullptr;
+    return _data->runState.fetch_or(RunningBit, std::memory_order_seq_cst) | RunningBit;
+}
+
+inline void Flow::Graph::setDeadline(const Deadline deadline) noexcept
+{
+    _data->deadline = deadline;
+    _data->deadlineBudget = deadline != NoDeadline ? deadline - DeadlineClock::now() : DeadlineClock::duration::zero();
+    _data->deadlineMissed.store(false, std::memory_order_relaxed);
+}
+
+inline void Flow::Graph::renewDeadline(void) noexcept
+{
+    _data->deadline = DeadlineClock::now() + _data->deadlineBudget;
+    _data->deadlineMissed.store(false, std::memory_order_relaxed);
+}
+
+inline bool Flow::Graph::cancelled(void) const noexcept
+{
+    if (!_data)
+        return false;
+    const auto state = _data->runState.load(std::memory_order_relaxed);
+    return ((state & RunningBit) && _data->cancelledRun.load(std::memory_order_relaxed) == state)
+        || (_data->parentNode && _data->parentNode->root->cancelled());
+}
+
+inline void Flow::Graph::cancelRun(const std::uint32_t state) noexcept
+{
+    // Run states are never reused, so cancelling a completed run can't reach a run started afterward
+    auto cancelled = _data->cancelledRun.load(std::memory_order_relaxed);
+    while ((state & RunningBit) && cancelled != state && runState() == state
+            && !_data->cancelledRun.compare_exchange_weak(cancelled, state, std::memory_order_relaxed));
+}
+
+inline void Flow::Graph::fail(std::exception_ptr exception) noexcept
+{
+    if (!_data->failed.exchange(true, std::memory_order_relaxed))
+        _data->exception = std::move(exception);
+    cancelRun(runState());
+}
+
+template<typename Clock, typename Duration>
+inline bool Flow::Graph::waitUntil(const std::chrono::time_point<Clock, Duration> &timeout) const noexcept
+{
+    for (auto state = runState(); state & RunningBit; state = runState()) {
+        if (!waitRunStateUntil(state, timeout))
+            return false;
+    }
+    return true;
+}
+
+inline void Flow::Graph::waitRunState(const std::uint32_t state) const noexcept
 {
-    while (running())
-        std::this_thread::yield();
+    while (runState() == state)
+        atomic_sync::atomic_wait_explicit(&_data->runState, state, std::memory_order_seq_cst);
 }
 
 inline void Flow::Graph::clearLinks(void) noexcept
@@ -48,13 +141,19 @@ inline void Flow::Graph::clearLinks(void) noexcept
         child->linkedFrom.clear();
         child->linkedTo.clear();
     }
+    if (_data)
+        invalidate();
 }
 
 inline void Flow::Graph::clear(void)
 {
     if (_data) {
-        wait();
+        waitCompletion();
+        // Functors of a compiled graph are released with it, there are no nodes left to move them back into
+        _data->compiled.reset();
         _data->children.clear();
+        _data->arena.clear();
+        invalidate();
     }
 }
 
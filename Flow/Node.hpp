@@ -7,7 +7,6 @@
 
 // This header must no be directly included, include 'Graph' instead
 
-#include <Core/PMR.hpp>
 #include <variant>
 #include <atomic>
 
@@ -16,6 +15,7 @@
 #include <Core/FlatString.hpp>
 
 #include "NodeType.hpp"
+#include "Coroutine.hpp"
 
 namespace Flow
 {
@@ -43,6 +43,13 @@ namespace Flow
 
     /** @brief Graph node is used to construct nested graphs */
     using GraphNode = Graph;
+
+    /** @brief Coroutine node holds coroutine functor and the coroutine suspended in the current run */
+    struct CoroutineNode
+    {
+        CoroutineFunc func;
+        Coroutine::Handle handle {};
+    };
 }
 
 /** @brief A node is a POD structure containing all data of a scheduled task in a graph */
@@ -53,11 +60,12 @@ struct alignas_double_cacheline Flow::Node
         Static = 0,
         Dynamic,
         Switch,
-        Graph
+        Graph,
+        Coroutine
     };
 
     /** @brief Variant holding work struct */
-    using WorkData = std::variant<StaticNode, DynamicNode, SwitchNode, GraphNode>;
+    using WorkData = std::variant<StaticNode, DynamicNode, SwitchNode, GraphNode, CoroutineNode>;
 
     // Cacheline 1, frequently used members
     WorkData workData {}; // Work data variant
@@ -68,7 +76,13 @@ struct alignas_double_cacheline Flow::Node
     NotifyFunc notifyFunc {}; // Notify functor
     Core::FlatString name; // Node name
     std::atomic<std::uint32_t> joined { 0 }; // Joining
+    std::uint32_t index { 0 }; // Index in the compiled graph, only valid while the root graph is compiled
     alignas(4) std::atomic<bool> bypass { 0 }; // Bypass the node as if it was executed if true
+    bool critical { false }; // Never bypassed when its graph misses its deadline
+    std::atomic<bool> notifyPending { false }; // Set while a coalesced notification of the node waits for delivery
+    Priority priority { Priority::Auto }; // Requested priority
+    Priority level { Priority::Normal }; // Effective priority, selects the ready queue of the node
+    bool fused { false }; // Executes its single successor right after itself without joining it, set on preprocess
     Graph *root { nullptr };
 
     /** @brief Construct a node with a work functor */
@@ -98,8 +112,11 @@ struct alignas_double_cacheline Flow::Node
     template<typename Work>
     inline static auto ForwardWorkData(Work &&work)
     {
+        // Coroutine functors are checked first as any callable converts to a static functor
+        if constexpr (!std::is_same_v<CoroutineNode, std::decay_t<Work>> && std::is_invocable_r_v<Coroutine, std::decay_t<Work> &>) {
+            return CoroutineNode { std::forward<Work>(work) };
         // Special rule for the dynamic node which can't specify its graph
-        if constexpr (std::is_same_v<DynamicFunc, Work> || std::is_constructible_v<DynamicFunc, Work>) {
+        } else if constexpr (std::is_same_v<DynamicFunc, Work> || std::is_constructible_v<DynamicFunc, Work>) {
             return DynamicNode {
                 std::forward<Work>(work),
                 Graph()
@@ -118,22 +135,21 @@ struct alignas_double_cacheline Flow::Node
 
 static_assert_fit_double_cacheline(Flow::Node);
 
+/** @brief Owns the lifetime of a node allocated in its graph's arena */
 class Flow::NodeInstance
 {
 public:
     /** @brief Default constructor */
     NodeInstance(void) = default;
 
-    /** @brief Allocate constructor */
-    template<typename ...Args>
-    NodeInstance(Args &&...args)
-        : _node(Allocate(std::forward<Args>(args)...)) {}
+    /** @brief Take ownership of a node constructed in an arena */
+    explicit NodeInstance(Node * const node) noexcept : _node(node) {}
 
     /** @brief Move constructor */
     NodeInstance(NodeInstance &&other) noexcept { swap(other); }
 
-    /** @brief Destroy the instance */
-    ~NodeInstance(void) { if (_node) Deallocate(_node); }
+    /** @brief Destroy the node, its memory is released by the arena */
+    ~NodeInstance(void) noexcept_destructible(Node) { if (_node) _node->~Node(); }
 
     /** @brief Get node pointer */
     [[nodiscard]] Node *node(void) noexcept { return _node; }
@@ -151,13 +167,4 @@ public:
 
 private:
     Node *_node { nullptr };
-
-    inline static std::pmr::synchronized_pool_resource _Pool {};
-
-    template<typename ...Args>
-    [[nodiscard]] inline static Node *Allocate(Args &&...args)
-        { return new (_Pool.allocate(sizeof(Node), alignof(Node))) Node(std::forward<Args>(args)...); }
-
-    inline static void Deallocate(Node *node) noexcept_destructible(Node)
-        { node->~Node(); return _Pool.deallocate(node, sizeof(Node), alignof(Node)); }
 };
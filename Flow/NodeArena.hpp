@@ -0,0 +1,78 @@
+/**
+ * @ Author: Matthieu Moinvaziri
+ * @ Description: Node arena
+ */
+
+#pragma once
+
+// This header must no be directly included, include 'Graph' instead
+
+#include <cstdint>
+
+#include <Core/PMR.hpp>
+#include <Core/Utils.hpp>
+
+namespace Flow
+{
+    struct Node;
+    class NodeArena;
+}
+
+/**
+ * @brief Chunked arena owning the memory of the nodes of a graph
+ *  Nodes are laid out contiguously in emplace order, each new chunk being twice larger than the previous one
+ *  The arena only manages memory: nodes must be destroyed before the arena is cleared or released
+ */
+class Flow::NodeArena
+{
+public:
+    /** @brief Node capacity of the first chunk */
+    static constexpr std::uint32_t MinChunkCapacity { 16u };
+
+    /** @brief Maximum node capacity of a chunk */
+    static constexpr std::uint32_t MaxChunkCapacity { 1024u };
+
+    /** @brief Construct the arena over an upstream memory resource */
+    NodeArena(std::pmr::memory_resource * const resource) noexcept : _resource(resource) {}
+
+    /** @brief Arenas can't be copied nor moved */
+    NodeArena(const NodeArena &other) = delete;
+    NodeArena &operator=(const NodeArena &other) = delete;
+
+    /** @brief Release every chunk */
+    ~NodeArena(void) noexcept { release(); }
+
+    /** @brief Get the upstream memory resource */
+    [[nodiscard]] std::pmr::memory_resource *resource(void) const noexcept { return _resource; }
+
+    /** @brief Construct a node inside the arena */
+    template<typename ...Args>
+    [[nodiscard]] Node *allocate(Args &&...args);
+
+    /** @brief Release every chunk but the largest one, which is reused by next allocations */
+    void clear(void) noexcept;
+
+    /** @brief Release every chunk */
+    void release(void) noexcept;
+
+private:
+    /** @brief Header of a chunk, followed by its nodes */
+    struct alignas_double_cacheline Chunk
+    {
+        Chunk *next { nullptr };
+        std::uint32_t size { 0u };
+        std::uint32_t capacity { 0u };
+    };
+
+    std::pmr::memory_resource *_resource { nullptr };
+    Chunk *_head { nullptr };
+
+    /** @brief Get the nodes of a chunk */
+    [[nodiscard]] static Node *NodesOf(Chunk * const chunk) noexcept { return reinterpret_cast<Node *>(chunk + 1); }
+
+    /** @brief Allocate a new head chunk */
+    void grow(void);
+
+    /** @brief Deallocate a chunk */
+    void deallocate(Chunk * const chunk) noexcept;
+};
@@ -0,0 +1,58 @@
+/**
+ * @ Author: Matthieu Moinvaziri
+ * @ Description: Node arena
+ */
+
+template<typename ...Args>
+inline Flow::Node *Flow::NodeArena::allocate(Args &&...args)
+{
+    static_assert(alignof(Node) <= alignof(Chunk), "Flow::NodeArena: Chunk header must be aligned as a node");
+
+    if (!_head || _head->size == _head->capacity) [[unlikely]]
+        grow();
+    const auto node = NodesOf(_head) + _head->size;
+    new (node) Node(std::forward<Args>(args)...);
+    ++_head->size;
+    return node;
+}
+
+inline void Flow::NodeArena::clear(void) noexcept
+{
+    if (!_head)
+        return;
+    for (auto chunk = _head->next; chunk;) {
+        const auto next = chunk->next;
+        deallocate(chunk);
+        chunk = next;
+    }
+    _head->next = nullptr;
+    _head->size = 0u;
+}
+
+inline void Flow::NodeArena::release(void) noexcept
+{
+    for (auto chunk = _head; chunk;) {
+        const auto next = chunk->next;
+        deallocate(chunk);
+        chunk = next;
+    }
+    _head = nullptr;
+}
+
+inline void Flow::NodeArena::grow(void)
+{
+    const std::uint32_t capacity = !_head ? MinChunkCapacity
+        : _head->capacity * 2u < MaxChunkCapacity ? _head->capacity * 2u : MaxChunkCapacity;
+    const auto chunk = new (_resource->allocate(sizeof(Chunk) + capacity * sizeof(Node), alignof(Chunk))) Chunk {
+        _head,
+        0u,
+        capacity
+    };
+
+    _head = chunk;
+}
+
+inline void Flow::NodeArena::deallocate(Chunk * const chunk) noexcept
+{
+    _resource->deallocate(chunk, sizeof(Chunk) + chunk->capacity * sizeof(Node), alignof(Chunk));
+}
@@ -12,6 +12,7 @@
 namespace Flow
 {
     class Graph;
+    class Coroutine;
 
     /** @brief Static functor */
     using StaticFunc = Core::Functor<void(void)>;
@@ -22,6 +23,9 @@ namespace Flow
     /** @brief Dynamic functor */
     using DynamicFunc = Core::Functor<void(Graph &)>;
 
+    /** @brief Coroutine functor, called on each run to create the coroutine of the node */
+    using CoroutineFunc = Core::Functor<Coroutine(void)>;
+
     /** @brief Notify functor to be called on the event thread */
     using NotifyFunc = Core::Functor<void(void)>;
 
@@ -30,9 +34,21 @@ namespace Flow
         Static = 0ul,
         Dynamic,
         Switch,
-        Graph
+        Graph,
+        Coroutine
+    };
+
+    /** @brief Priority of a node, ready nodes of higher priority are executed and stolen first */
+    enum class Priority : std::uint8_t {
+        Low = 0u,
+        Normal,
+        High,
+        Auto        // Computed on preprocess: High on a critical path of its graph, else Normal
     };
 
+    /** @brief Number of ready queues of a worker, one per priority */
+    constexpr std::size_t PriorityCount { static_cast<std::size_t>(Priority::Auto) };
+
     /** @brief Empty work placeholder */
     constexpr auto EmptyWork = []{};
 }
\ No newline at end of file
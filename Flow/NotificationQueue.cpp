@@ -0,0 +1,60 @@
+/**
+ * @ Author: Matthieu Moinvaziri
+ * @ Description: Per-worker notification queue
+ */
+
+#include <bit>
+
+#include "NotificationQueue.hpp"
+
+Flow::NotificationQueue::Segment::Segment(const std::size_t capacity)
+    : mask(capacity - 1ul)
+{
+    slots.allocate(capacity, nullptr);
+}
+
+Flow::NotificationQueue::NotificationQueue(const std::size_t capacity)
+{
+    _head = new Segment(std::bit_ceil(capacity ? capacity : 1ul));
+    _tail = _head;
+}
+
+Flow::NotificationQueue::~NotificationQueue(void)
+{
+    for (auto *segment = _head; segment; ) {
+        auto * const next = segment->next.load(std::memory_order_relaxed);
+        delete segment;
+        segment = next;
+    }
+}
+
+Flow::NotificationQueue::PushResult Flow::NotificationQueue::push(Node * const node, const OverflowPolicy policy)
+{
+    auto result = PushResult::Queued;
+
+    if (policy == OverflowPolicy::Coalesce && node->notifyPending.exchange(true, std::memory_order_acq_rel))
+        return PushResult::Coalesced;
+    auto * const segment = _tail;
+    const auto tail = segment->tail.load(std::memory_order_relaxed);
+    const auto capacity = segment->mask + 1ul;
+    for (auto head = segment->head.load(std::memory_order_acquire); tail - head >= capacity; ) {
+        if (policy != OverflowPolicy::DropOldest) {
+            auto * const next = new Segment(capacity * 2ul);
+            next->slots[0].store(node, std::memory_order_relaxed);
+            next->tail.store(1u, std::memory_order_relaxed);
+            segment->next.store(next, std::memory_order_release);
+            _tail = next;
+            return result;
+        }
+        // Slots are only written by the producer, so the oldest notification can be read before being dropped
+        auto * const oldest = segment->slots[static_cast<std::size_t>(head) & segment->mask].load(std::memory_order_relaxed);
+        if (segment->head.compare_exchange_weak(head, head + 1u, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            oldest->notifyPending.store(false, std::memory_order_relaxed);
+            result = PushResult::DroppedOldest;
+            ++head;
+        }
+    }
+    segment->slots[static_cast<std::size_t>(tail) & segment->mask].store(node, std::memory_order_relaxed);
+    segment->tail.store(tail + 1u, std::memory_order_release);
+    return result;
+}
@@ -0,0 +1,86 @@
+/**
+ * @ Author: Matthieu Moinvaziri
+ * @ Description: Per-worker notification queue
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include <Core/HeapArray.hpp>
+
+namespace Flow
+{
+    struct Node;
+    class NotificationQueue;
+}
+
+/**
+ * @brief Notifications pushed by a single worker and delivered in bulk on the event processing thread
+ *  The owner worker is the only producer and the event thread the only consumer, a push never waits for the consumer
+ *  Once full, the overflow policy either chains a segment twice as large or drops the oldest pending notification
+ */
+class alignas_double_cacheline Flow::NotificationQueue
+{
+public:
+    /** @brief Default notification capacity of a queue */
+    static constexpr std::size_t DefaultCapacity { 4096ul };
+
+    /** @brief Maximum number of notifications consumed at once by 'drain' */
+    static constexpr std::size_t BatchSize { 64ul };
+
+    /** @brief Behavior of a push into a full queue */
+    enum class OverflowPolicy {
+        Grow,       // Chain a larger segment, no notification is ever lost
+        Coalesce,   // Grow, but a node whose notification is still pending is not queued again
+        DropOldest  // Overwrite the oldest pending notification
+    };
+
+    /** @brief Outcome of a push */
+    enum class PushResult {
+        Queued,         // The notification is queued
+        Coalesced,      // The node was already pending, nothing is queued
+        DroppedOldest   // The notification is queued in place of the oldest pending one
+    };
+
+    /** @brief Construct the queue, the capacity is rounded up to a power of 2 */
+    NotificationQueue(const std::size_t capacity = DefaultCapacity);
+
+    /** @brief Destroy every segment, pending notifications are lost */
+    ~NotificationQueue(void);
+
+    /** @brief Notification queues can't be copied nor moved */
+    NotificationQueue(const NotificationQueue &other) = delete;
+    NotificationQueue &operator=(const NotificationQueue &other) = delete;
+
+    /** @brief Queue the notification of a node (only the owner worker may call this) */
+    PushResult push(Node * const node, const OverflowPolicy policy);
+
+    /** @brief Call 'callback' on every pending node, in push order, returns the number of delivered notifications
+     *  Only the event processing thread may call this, the pending flag of a node is cleared before its callback
+     *  If a callback throws, the exception is propagated and the following notifications are delivered by the next drain */
+    template<typename Callback>
+    std::size_t drain(Callback &&callback);
+
+private:
+    /** @brief Fixed capacity ring of notifications, once full the producer links a larger successor */
+    struct Segment
+    {
+        Segment(const std::size_t capacity);
+
+        alignas_cacheline std::atomic<std::uint64_t> head { 0u }; // Next notification to deliver, advanced by the consumer (and the producer when dropping)
+        alignas_cacheline std::atomic<std::uint64_t> tail { 0u }; // Next free slot, only written by the producer
+        std::atomic<Segment *> next { nullptr }; // Successor, the producer never writes into a segment once it is linked
+        std::size_t mask { 0ul };
+        Core::HeapArray<std::atomic<Node *>> slots {};
+    };
+
+    alignas_cacheline Segment *_head { nullptr }; // Segment read by the consumer
+    std::size_t _batchIndex { 0ul }; // Next notification of the batch to deliver
+    std::size_t _batchCount { 0ul }; // Number of notifications in the batch
+    Node *_batch[BatchSize] {}; // Notifications taken from the head segment, not all delivered yet
+    alignas_cacheline Segment *_tail { nullptr }; // Segment written by the producer
+};
+
+#include "NotificationQueue.ipp"
@@ -0,0 +1,44 @@
+/**
+ * @ Author: Matthieu Moinvaziri
+ * @ Description: Per-worker notification queue
+ */
+
+#include "Graph.hpp"
+
+template<typename Callback>
+inline std::size_t Flow::NotificationQueue::drain(Callback &&callback)
+{
+    std::size_t delivered = 0ul;
+
+    for (;;) {
+        // The batch is consumed one notification at a time, so a throwing callback leaves the rest for the next drain
+        while (_batchIndex != _batchCount) {
+            const auto node = _batch[_batchIndex++];
+            node->notifyPending.exchange(false, std::memory_order_acq_rel);
+            callback(node);
+            ++delivered;
+        }
+        auto * const segment = _head;
+        const auto tail = segment->tail.load(std::memory_order_acquire);
+        auto head = segment->head.load(std::memory_order_acquire);
+        if (head == tail) {
+            auto * const next = segment->next.load(std::memory_order_acquire);
+            if (!next)
+                return delivered;
+            // Notifications pushed before the link may not have been seen yet
+            if (segment->tail.load(std::memory_order_acquire) != head)
+                continue;
+            _head = next;
+            delete segment;
+            continue;
+        }
+        const auto count = static_cast<std::size_t>(tail - head) < BatchSize ? static_cast<std::size_t>(tail - head) : BatchSize;
+        for (auto i = 0ul; i < count; ++i)
+            _batch[i] = segment->slots[static_cast<std::size_t>(head + i) & segment->mask].load(std::memory_order_relaxed);
+        // Fails if the producer dropped notifications meanwhile, the batch is read again
+        if (!segment->head.compare_exchange_strong(head, head + count, std::memory_order_acq_rel, std::memory_order_relaxed))
+            continue;
+        _batchIndex = 0ul;
+        _batchCount = count;
+    }
+}
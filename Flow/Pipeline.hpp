@@ -0,0 +1,163 @@
+/**
+ * @ Author: Matthieu Moinvaziri
+ * @ Description: Streaming pipeline
+ */
+
+#pragma once
+
+#include <variant>
+#include <vector>
+
+#include <Core/Functor.hpp>
+#include <Core/HeapArray.hpp>
+
+#include "Scheduler.hpp"
+
+namespace Flow
+{
+    /** @brief Execution constraint of a pipeline stage */
+    enum class StageType {
+        Serial,     // Tokens pass through the stage one at a time, in token order
+        Parallel    // Tokens pass through the stage concurrently
+    };
+
+    template<typename Scratch>
+    class Pipeflow;
+
+    template<typename Scratch = std::monostate>
+    class Pipeline;
+}
+
+/** @brief Context of a token passing through a pipeline stage */
+template<typename Scratch>
+class Flow::Pipeflow
+{
+public:
+    /** @brief Get the index of the token, tokens are numbered in the order the first stage produced them */
+    [[nodiscard]] std::size_t token(void) const noexcept { return _token; }
+
+    /** @brief Get the line carrying the token, a line carries a single token at a time */
+    [[nodiscard]] std::size_t line(void) const noexcept { return _line; }
+
+    /** @brief Get the index of the current stage */
+    [[nodiscard]] std::size_t stage(void) const noexcept { return _stage; }
+
+    /** @brief Get the scratch slot of the current stage for the token's line */
+    [[nodiscard]] Scratch &scratch(void) noexcept { return _pipeline.scratch(_line, _stage); }
+
+    /** @brief Get the scratch slot of another stage for the token's line, used to pass data between stages */
+    [[nodiscard]] Scratch &scratch(const std::size_t stage) noexcept { return _pipeline.scratch(_line, stage); }
+
+    /** @brief Stop producing tokens, only valid in the first stage
+     *  The current token is discarded while the tokens already produced flow through the remaining stages */
+    void stop(void) noexcept { _stopped = true; }
+
+private:
+    Pipeline<Scratch> &_pipeline;
+    std::size_t _token;
+    std::size_t _line;
+    std::size_t _stage;
+    bool _stopped { false };
+
+    /** @brief Construct the context of a stage */
+    Pipeflow(Pipeline<Scratch> &pipeline, const std::size_t token, const std::size_t line, const std::size_t stage) noexcept
+        : _pipeline(pipeline), _token(token), _line(line), _stage(stage) {}
+
+    friend Pipeline<Scratch>;
+};
+
+/**
+ * @brief Pipeline of stages processing a stream of tokens, with at most 'lineCount' tokens in flight
+ *  Unlike a repeated graph, the stages of successive tokens overlap: stage N + 1 of token K runs while stage N processes token K + 1
+ *  The first stage must be serial, it produces a token each time it is called until it calls 'stop'
+ *  Each line owns a scratch slot per stage, reused by the tokens it carries
+ *
+ * @example
+ *  Flow::Pipeline<Block> pipeline(4);
+ *  pipeline.stage(Flow::StageType::Serial, [&](auto &flow) { if (!decode(flow.scratch())) flow.stop(); })
+ *          .stage(Flow::StageType::Parallel, [](auto &flow) { process(flow.scratch(0), flow.scratch()); })
+ *          .stage(Flow::StageType::Serial, [&](auto &flow) { write(flow.scratch(1)); });
+ *  scheduler.schedule(pipeline.graph()).wait();
+ */
+template<typename Scratch>
+class Flow::Pipeline
+{
+public:
+    /** @brief Stage functor */
+    using StageFunc = Core::Functor<void(Pipeflow<Scratch> &)>;
+
+    /** @brief Construct a pipeline with a fixed number of lines (in-flight tokens) */
+    Pipeline(const std::size_t lineCount);
+
+    /** @brief Pipelines can't be copied nor moved as their proxy tasks reference them */
+    Pipeline(const Pipeline &other) = delete;
+    Pipeline &operator=(const Pipeline &other) = delete;
+
+    /** @brief Destroy the pipeline once its run is completed */
+    ~Pipeline(void) { _graph.waitCompletion(); }
+
+    /** @brief Append a stage, stages can't be added once the graph was retrieved */
+    template<typename Callable>
+    Pipeline &stage(const StageType type, Callable &&callable);
+
+    /** @brief Get the graph to schedule on a Scheduler */
+    [[nodiscard]] Graph &graph(void);
+
+    /** @brief Get the number of lines */
+    [[nodiscard]] std::size_t lineCount(void) const noexcept { return _lines.size(); }
+
+    /** @brief Get the number of stages */
+    [[nodiscard]] std::size_t stageCount(void) const noexcept { return _stages.size(); }
+
+    /** @brief Get the number of tokens produced by the last run (only consistent once the run is completed) */
+    [[nodiscard]] std::size_t tokenCount(void) const noexcept { return _tokenCount; }
+
+    /** @brief Get the scratch slot of a line's stage */
+    [[nodiscard]] Scratch &scratch(const std::size_t line, const std::size_t stage) noexcept { return _scratches[line * stageCount() + stage]; }
+
+private:
+    /** @brief Index of an absent line */
+    static constexpr std::size_t NoLine { ~0ul };
+
+    /** @brief Stage description */
+    struct Stage
+    {
+        StageFunc func {};
+        StageType type { StageType::Serial };
+    };
+
+    /** @brief Progress of a line, written by the stage that makes the line ready */
+    struct alignas_cacheline Line
+    {
+        std::size_t stage { 0ul }; // Next stage to execute
+        std::size_t token { 0ul }; // Token carried by the line
+        bool started { false }; // True once the line proxy was dispatched by the run
+    };
+
+    std::vector<Stage> _stages {};
+    Core::HeapArray<Line> _lines {};
+    Core::HeapArray<std::atomic<std::uint32_t>> _joins {}; // Pending dependencies of each line's stage
+    Core::HeapArray<Scratch> _scratches {};
+    std::vector<Task> _proxies {};
+    std::size_t _tokenCount { 0ul };
+    Graph _graph {};
+
+    /** @brief Get the number of dependencies of a stage: the previous stage of its token, and the previous token of a serial stage */
+    [[nodiscard]] std::uint32_t joinCount(const std::size_t stage) const noexcept
+        { return 1u + (_stages[stage].type == StageType::Serial); }
+
+    /** @brief Reset the state of every line before a run (executed by the root proxy) */
+    void start(void) noexcept;
+
+    /** @brief Execute a line proxy: the first dispatch of a run frees the line for its first token, later ones execute its ready stage
+     *  Ready continuations are then executed in place */
+    void run(const std::size_t line);
+
+    /** @brief Execute the ready stage of a line, returns the first line made ready or NoLine */
+    [[nodiscard]] std::size_t execute(const std::size_t line);
+
+    /** @brief Join a line's stage, the first ready line becomes 'next' and the others are spawned */
+    void join(const std::size_t line, const std::size_t stage, std::size_t &next) noexcept;
+};
+
+#include "Pipeline.ipp"
@@ -0,0 +1,121 @@
+/**
+ * @ Author: Matthieu Moinvaziri
+ * @ Description: Streaming pipeline
+ */
+
+template<typename Scratch>
+inline Flow::Pipeline<Scratch>::Pipeline(const std::size_t lineCount)
+{
+    if (!lineCount)
+        throw std::logic_error("Flow::Pipeline: Pipeline must have at least one line");
+    _lines.allocate(lineCount);
+}
+
+template<typename Scratch>
+template<typename Callable>
+inline Flow::Pipeline<Scratch> &Flow::Pipeline<Scratch>::stage(const StageType type, Callable &&callable)
+{
+    if (!_proxies.empty())
+        throw std::logic_error("Flow::Pipeline::stage: Can't add a stage once the graph was retrieved");
+    if (_stages.empty() && type != StageType::Serial)
+        throw std::logic_error("Flow::Pipeline::stage: First stage must be serial");
+    _stages.push_back(Stage { StageFunc(std::forward<Callable>(callable)), type });
+    return *this;
+}
+
+template<typename Scratch>
+inline Flow::Graph &Flow::Pipeline<Scratch>::graph(void)
+{
+    if (!_proxies.empty())
+        return _graph;
+    if (_stages.empty())
+        throw std::logic_error("Flow::Pipeline::graph: Pipeline must have at least one stage");
+    _joins.allocate(lineCount() * stageCount(), 0u);
+    _scratches.allocate(lineCount() * stageCount());
+    _proxies.reserve(lineCount());
+    // The root resets the pipeline, then each line proxy is dispatched once by the run and spawned again each time its line is ready
+    auto root = _graph.emplace([this] { start(); });
+    for (auto line = 0ul; line < lineCount(); ++line) {
+        auto proxy = _graph.emplace([this, line] { run(line); });
+        root.precede(proxy);
+        _proxies.push_back(proxy);
+    }
+    _graph.preprocess();
+    return _graph;
+}
+
+template<typename Scratch>
+inline void Flow::Pipeline<Scratch>::start(void) noexcept
+{
+    _tokenCount = 0ul;
+    for (auto line = 0ul; line < lineCount(); ++line) {
+        _lines[line].stage = 0ul;
+        _lines[line].started = false;
+        for (auto stage = 0ul; stage < stageCount(); ++stage) {
+            // The first token has no previous token to wait for
+            const auto initial = joinCount(stage) - (!line && _stages[stage].type == StageType::Serial);
+            _joins[line * stageCount() + stage].store(initial, std::memory_order_relaxed);
+        }
+    }
+}
+
+template<typename Scratch>
+inline void Flow::Pipeline<Scratch>::run(const std::size_t line)
+{
+    auto next = line;
+
+    if (!_lines[line].started) {
+        _lines[line].started = true;
+        next = NoLine;
+        join(line, 0ul, next);
+    }
+    while (next != NoLine)
+        next = execute(next);
+}
+
+template<typename Scratch>
+inline std::size_t Flow::Pipeline<Scratch>::execute(const std::size_t line)
+{
+    auto &state = _lines[line];
+    const auto stage = state.stage;
+    std::size_t next = NoLine;
+
+    // Lines of a cancelled or failed run stop where they are, the run completes once every spawned line is executed
+    if (_graph.cancelled())
+        return NoLine;
+    if (!stage)
+        state.token = _tokenCount;
+    Pipeflow<Scratch> flow(*this, state.token, line, stage);
+    try {
+        _stages[stage].func(flow);
+    } catch (...) {
+        _graph.fail(std::current_exception());
+        return NoLine;
+    }
+    if (!stage) {
+        // A stopped pipeline releases neither the token nor the next line, so no other token is produced
+        if (flow._stopped)
+            return NoLine;
+        ++_tokenCount;
+    }
+    // The stage is reset before its successors are joined, as they are the only ones to join it again
+    _joins[line * stageCount() + stage].store(joinCount(stage), std::memory_order_relaxed);
+    join(line, stage + 1ul < stageCount() ? stage + 1ul : 0ul, next);
+    if (_stages[stage].type == StageType::Serial)
+        join(line + 1ul < lineCount() ? line + 1ul : 0ul, stage, next);
+    return next;
+}
+
+template<typename Scratch>
+inline void Flow::Pipeline<Scratch>::join(const std::size_t line, const std::size_t stage, std::size_t &next) noexcept
+{
+    if (_joins[line * stageCount() + stage].fetch_sub(1u, std::memory_order_acq_rel) != 1u)
+        return;
+    _lines[line].stage = stage;
+    if (next == NoLine)
+        next = line;
+    else {
+        _graph.childScheduled();
+        _graph.scheduler()->spawn(_proxies[line]);
+    }
+}
@@ -3,20 +3,114 @@
  * @ Description: Task Scheduler
  */
 
+#ifdef __linux__
+# include <sys/eventfd.h>
+# include <unistd.h>
+#endif
+
+#include <string>
+
 #include "Scheduler.hpp"
 
-Flow::Scheduler::Scheduler(const std::size_t workerCount, const std::size_t taskQueueSize, const std::size_t notificationQueueSize)
-    : _notifications(notificationQueueSize)
+Flow::Scheduler::Scheduler(const std::size_t workerCount, const std::size_t notificationQueueSize)
+    : Scheduler(workerCount, StealPolicy {}, notificationQueueSize)
+{
+}
+
+Flow::Scheduler::Scheduler(const std::size_t workerCount, const StealPolicy &stealPolicy, const std::size_t notificationQueueSize)
 {
     auto count = workerCount;
     if (count == AutoWorkerCount)
         count = std::thread::hardware_concurrency();
     if (!count)
         count = DefaultWorkerCount;
+    _cache.stealPolicy = stealPolicy;
+    startWorkers(count, notificationQueueSize, {}, {}, false);
+}
+
+Flow::Scheduler::Scheduler(const std::size_t workerCount, const PlacementPolicy &placement, const std::size_t notificationQueueSize)
+{
+    const auto topology = (placement.topology.empty() ? CpuTopology::Detect() : placement.topology).exclude(placement.excludedCpus);
+    std::vector<CpuInfo> used;
+
+    if (placement.cpus.empty())
+        used = topology.cpus();
+    else {
+        for (const auto id : placement.cpus) {
+            const auto cpu = topology.find(id);
+            if (!cpu)
+                throw std::logic_error("Flow::Scheduler::Scheduler: CPU " + std::to_string(id) + " is excluded or not available");
+            used.push_back(*cpu);
+        }
+    }
+    if (used.empty())
+        throw std::logic_error("Flow::Scheduler::Scheduler: Every CPU is excluded");
+    const auto count = workerCount == AutoWorkerCount ? used.size() : workerCount;
+    if (placement.pinWorkers) {
+        std::vector<CpuInfo> cpus;
+        cpus.reserve(count);
+        for (auto i = 0ul; i < count; ++i)
+            cpus.push_back(used[i % used.size()]);
+        startWorkers(count, notificationQueueSize, cpus, {}, placement.hierarchicalSteal);
+    } else {
+        std::vector<std::uint32_t> allowed;
+        allowed.reserve(used.size());
+        for (const auto &cpu : used)
+            allowed.push_back(cpu.id);
+        startWorkers(count, notificationQueueSize, {}, allowed, false);
+    }
+}
+
+void Flow::Scheduler::startWorkers(const std::size_t workerCount, const std::size_t notificationQueueSize,
+        const std::vector<CpuInfo> &cpus, const std::vector<std::uint32_t> &allowed, const bool hierarchicalSteal)
+{
+    const auto count = workerCount;
     _lastWorkerId = count - 1;
-    _cache.workers.allocate(count, this, taskQueueSize);
-    for (auto &worker : _cache.workers)
-        worker.start();
+    _cache.workers.allocate(count, this);
+    _cache.notificationQueues.allocate(count, notificationQueueSize);
+    _cache.workerCpus.allocate(count, NoCpu);
+    for (auto i = 0ul; i < count; ++i)
+        _cache.workers[i].setNotificationQueue(&_cache.notificationQueues[i]);
+
+    // Workers pin themselves before running anything, then wait for their steal order
+    _startingWorkers.store(count, std::memory_order_relaxed);
+    for (auto i = 0ul; i < count; ++i) {
+        if (!cpus.empty())
+            _cache.workers[i].start(i, { cpus[i].id });
+        else
+            _cache.workers[i].start(i, std::vector<std::uint32_t>(allowed));
+    }
+    for (auto starting = _startingWorkers.load(std::memory_order_acquire); starting; starting = _startingWorkers.load(std::memory_order_acquire))
+        atomic_sync::atomic_wait_explicit(&_startingWorkers, starting, std::memory_order_acquire);
+
+    // Order the victims of each worker by distance, workers without a pinned CPU are all remote
+    _cache.victims.allocate(count * (count - 1));
+    _cache.victimRanges.allocate(count * CpuDistanceCount, 0u);
+    for (auto thief = 0ul; thief < count; ++thief) {
+        const auto victims = &_cache.victims[thief * (count - 1)];
+        const auto ranges = &_cache.victimRanges[thief * CpuDistanceCount];
+        auto size = 0u;
+        for (auto distance = 0ul; distance < CpuDistanceCount; ++distance) {
+            for (auto victim = 0ul; victim < count; ++victim) {
+                const auto known = hierarchicalSteal && _cache.workerCpus[thief] != NoCpu && _cache.workerCpus[victim] != NoCpu;
+                const auto victimDistance = known ? CpuTopology::Distance(cpus[thief], cpus[victim]) : CpuDistance::Remote;
+                if (victim != thief && static_cast<std::size_t>(victimDistance) == distance)
+                    victims[size++] = static_cast<std::uint32_t>(victim);
+            }
+            ranges[distance] = size;
+        }
+    }
+    _startingWorkers.store(WorkersReady, std::memory_order_release);
+    atomic_sync::atomic_notify_all(&_startingWorkers);
+}
+
+void Flow::Scheduler::workerStarted(const std::size_t workerIndex, const std::uint32_t cpu) noexcept
+{
+    _cache.workerCpus[workerIndex] = cpu;
+    if (_startingWorkers.fetch_sub(1u, std::memory_order_acq_rel) == 1u)
+        atomic_sync::atomic_notify_all(&_startingWorkers);
+    for (auto starting = _startingWorkers.load(std::memory_order_acquire); starting != WorkersReady; starting = _startingWorkers.load(std::memory_order_acquire))
+        atomic_sync::atomic_wait_explicit(&_startingWorkers, starting, std::memory_order_acquire);
 }
 
 Flow::Scheduler::~Scheduler(void)
@@ -25,31 +119,161 @@ Flow::Scheduler::~Scheduler(void)
         worker.stop();
     for (auto &worker: _cache.workers)
         worker.join();
+    disableNotificationHandle();
 }
 
-bool Flow::Scheduler::steal(Flow::Task &task) noexcept
+std::size_t Flow::Scheduler::processNotifications(void)
 {
-    for (auto &worker : _cache.workers) {
-        if (worker.steal(task))
-            return true;
+    std::size_t count = 0ul;
+
+    // Reset the handle before draining, so a notification queued meanwhile signals it again
+    // The eventfd is read before the flag is cleared, else a signal sent in between would be consumed while the flag stays set
+    if (_cache.notificationHandle != InvalidNotificationHandle && _notificationSignalled.load()) {
+#ifdef __linux__
+        eventfd_t value;
+        ::eventfd_read(_cache.notificationHandle, &value);
+#endif
+        _notificationSignalled.store(false);
     }
-    return false;
+
+    try {
+        for (auto &queue : _cache.notificationQueues)
+            count += queue.drain([](Node * const node) { node->notifyFunc(); });
+    } catch (...) {
+        // The handle was reset, signal it again for the notifications left after the throwing one
+        notificationQueued();
+        throw;
+    }
+    return count;
+}
+
+int Flow::Scheduler::enableNotificationHandle(void)
+{
+#ifdef __linux__
+    if (_cache.notificationHandle == InvalidNotificationHandle) {
+        _cache.notificationHandle = ::eventfd(0u, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (_cache.notificationHandle == InvalidNotificationHandle)
+            throw std::runtime_error("Flow::Scheduler::enableNotificationHandle: Couldn't create eventfd");
+        // Notifications queued before the handle existed must wake up the event loop too
+        _notificationSignalled.store(true);
+        signalNotificationHandle();
+    }
+    return _cache.notificationHandle;
+#else
+    throw std::logic_error("Flow::Scheduler::enableNotificationHandle: Notification handle is only supported on Linux");
+#endif
 }
 
-void Flow::Scheduler::wait(void) noexcept
+void Flow::Scheduler::disableNotificationHandle(void) noexcept
+{
+#ifdef __linux__
+    if (_cache.notificationHandle != InvalidNotificationHandle)
+        ::close(_cache.notificationHandle);
+#endif
+    _cache.notificationHandle = InvalidNotificationHandle;
+    _notificationSignalled.store(false);
+}
+
+void Flow::Scheduler::signalNotificationHandle(void) noexcept
+{
+#ifdef __linux__
+    ::eventfd_write(_cache.notificationHandle, 1u);
+#endif
+}
+
+Flow::SchedulerStats Flow::Scheduler::stats(void) const
+{
+    SchedulerStats stats;
+
+    stats.workers.reserve(workerCount());
+    for (const auto &worker : _cache.workers)
+        stats.workers.push_back(worker.stats());
+    stats.externalWakeUps = _externalWakeUps.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void Flow::Scheduler::enableTracing(const std::size_t capacity)
+{
+    if constexpr (!TracingEnabled)
+        return;
+    disableTracing();
+    _cache.traceBuffers.allocate(workerCount(), capacity);
+    for (auto i = 0ul; i < workerCount(); ++i)
+        _cache.workers[i].setTraceBuffer(&_cache.traceBuffers[i]);
+}
+
+void Flow::Scheduler::disableTracing(void) noexcept
+{
+    for (auto &worker : _cache.workers)
+        worker.setTraceBuffer(nullptr);
+    _cache.traceBuffers.release();
+}
+
+bool Flow::Scheduler::steal(Worker &thief, Task &task) noexcept
 {
     const auto count = workerCount();
+    const auto thiefId = workerIndex(thief);
+    const bool stealHalf = _cache.stealPolicy.stealHalf;
+    const auto victims = _cache.victims.begin() + thiefId * (count - 1);
+    const auto ranges = _cache.victimRanges.begin() + thiefId * CpuDistanceCount;
+    auto begin = 0u;
 
-    while (true) {
-        {
-            auto activeCount = count;
-            for (auto &worker : _cache.workers) {
-                if (!worker.taskCount())
-                    --activeCount;
-            }
-            if (!activeCount)
-                return;
+    for (auto distance = 0ul; distance < CpuDistanceCount; begin = ranges[distance++]) {
+        const auto size = ranges[distance] - begin;
+        if (!size)
+            continue;
+        auto offset = static_cast<std::uint32_t>(thief.random() % size);
+        for (auto i = 0u; i < size; ++i) {
+            auto &victim = _cache.workers[victims[begin + offset]];
+            if (stealHalf ? victim.stealHalf(thief, task) : victim.steal(task))
+                return true;
+            if (++offset == size)
+                offset = 0u;
         }
-        std::this_thread::yield();
     }
-}
\ No newline at end of file
+    return false;
+}
+
+std::vector<std::size_t> Flow::Scheduler::stealOrder(const std::size_t workerIndex) const
+{
+    const auto count = workerCount();
+    const auto victims = _cache.victims.begin() + workerIndex * (count - 1);
+
+    return std::vector<std::size_t>(victims, victims + (count - 1));
+}
+
+void Flow::Scheduler::schedule(const Task * const begin, const Task * const end) noexcept
+{
+    const auto taskCount = static_cast<std::size_t>(end - begin);
+    const auto count = workerCount();
+    const auto targetCount = taskCount < count ? taskCount : count;
+
+    if (taskCount <= 1ul) {
+        if (taskCount)
+            schedule(*begin);
+        return;
+    }
+    const auto firstId = reserveWorkers(targetCount);
+    const auto chunk = taskCount / targetCount;
+    const auto remainder = taskCount % targetCount;
+    auto it = begin;
+    for (auto i = 0ul, id = firstId; i < targetCount; ++i) {
+        const auto next = it + chunk + (i < remainder);
+        _cache.workers[id].submit(it, next);
+        it = next;
+        if (++id == count)
+            id = 0;
+    }
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    for (auto i = 0ul, id = firstId; i < targetCount; ++i) {
+        _cache.workers[id].tryWakeUp();
+        if (++id == count)
+            id = 0;
+    }
+}
+
+void Flow::Scheduler::waitGraphs(void) const noexcept
+{
+    for (auto count = _activeGraphs.load(std::memory_order_acquire); count; count = _activeGraphs.load(std::memory_order_acquire))
+        atomic_sync::atomic_wait_explicit(&_activeGraphs, count, std::memory_order_acquire);
+}
@@ -10,6 +10,8 @@
 #include <Core/HeapArray.hpp>
 
 #include "Worker.hpp"
+#include "Future.hpp"
+#include "Topology.hpp"
 
 namespace Flow
 {
@@ -26,51 +28,278 @@ public:
     /** @brief This variable is used on hardware thread detection failure */
     static constexpr std::size_t DefaultWorkerCount { 4ul };
 
-    /** @brief Default queue size of tasks */
-    static constexpr std::size_t DefaultTaskQueueSize { 4096ul };
+    /** @brief Default notification queue size of each worker, any size is rounded up to a power of 2 */
+    static constexpr std::size_t DefaultNotificationQueueSize { NotificationQueue::DefaultCapacity };
 
-    /** @brief Default queue size of notifications */
-    static constexpr std::size_t DefaultNotificationQueueSize { 4096ul };
+    /** @brief Behavior of a worker notification queue once full */
+    using NotificationPolicy = NotificationQueue::OverflowPolicy;
+
+    /** @brief Value of a disabled notification handle */
+    static constexpr int InvalidNotificationHandle { -1 };
+
+    /** @brief Policy used by idle workers to steal tasks from other workers
+     *  An idle worker searches for work by spinning between steal passes, then yielding between passes, then parks */
+    struct StealPolicy
+    {
+        std::uint32_t attempts { 8u }; // Number of full steal passes separated by spinning
+        std::uint32_t backoffMinSpins { 16u }; // Spin count after the first failed pass
+        std::uint32_t backoffMaxSpins { 1024u }; // Maximum spin count between two passes
+        bool stealHalf { false }; // If true, a successful steal takes half of the victim's tasks
+        std::uint32_t yields { 0u }; // Number of steal passes separated by a thread yield, once spinning passes failed
+        bool keepSearching { false }; // If true, the last searching worker never parks while others are parked, so new tasks are found without wake-up
+    };
+
+    /** @brief Placement of the workers on the CPUs of the machine */
+    struct PlacementPolicy
+    {
+        CpuTopology topology {}; // Topology used to place workers, empty detects the CPUs the process may run on
+        std::vector<std::uint32_t> cpus {}; // CPUs used by workers in worker order (wrapping around), empty uses the whole topology
+        std::vector<std::uint32_t> excludedCpus {}; // CPUs never used by workers, i.e. reserved for an audio I/O thread
+        bool pinWorkers { true }; // If true, each worker is pinned to a single CPU, else workers may run on any of the used CPUs
+        bool hierarchicalSteal { true }; // If true, pinned workers steal from their SMT sibling, then their last level cache, then remote ones
+    };
+
+    /** @brief Index of a worker that isn't pinned to a CPU */
+    static constexpr std::uint32_t NoCpu { CpuTopology::NoCpu };
+
+    /** @brief Behavior of a graph run once it missed its deadline */
+    enum class DeadlinePolicy {
+        Continue,           // Execute the remaining nodes normally
+        BypassNonCritical   // Bypass every remaining node that is not marked as critical
+    };
 
     /** @brief Construct a set of workers and start scheduler */
-    Scheduler(const std::size_t workerCount = AutoWorkerCount, const std::size_t taskQueueSize = DefaultTaskQueueSize, const std::size_t notificationQueueSize = DefaultNotificationQueueSize);
+    Scheduler(const std::size_t workerCount = AutoWorkerCount, const std::size_t notificationQueueSize = DefaultNotificationQueueSize);
+
+    /** @brief Construct a set of workers using a steal policy from their start and start scheduler */
+    Scheduler(const std::size_t workerCount, const StealPolicy &stealPolicy, const std::size_t notificationQueueSize = DefaultNotificationQueueSize);
+
+    /** @brief Construct a set of workers placed on CPUs and start scheduler
+     *  An automatic worker count starts a worker per used CPU, the workers of a smaller count fill a last level cache before the next one
+     *  Throws if a requested CPU isn't part of the topology or if every CPU is excluded */
+    Scheduler(const std::size_t workerCount, const PlacementPolicy &placement, const std::size_t notificationQueueSize = DefaultNotificationQueueSize);
 
     /** @brief Destroy and join all workers */
     ~Scheduler(void);
 
-    /** @brief Schedule a graph of tasks
-     *  IsRepeating is used internally to repeat graphs */
-    template<bool IsRepeating = false>
-    void schedule(Graph &task);
+    /** @brief Schedule a graph of tasks, the returned future becomes ready when the run is completed */
+    Future schedule(Graph &graph);
+
+    /** @brief Schedule a graph of tasks and call 'onComplete' on the worker thread that completes the run
+     *  The callback is called after the run is published as completed, so it may schedule the graph again */
+    template<typename Callback, std::enable_if_t<std::is_invocable_v<Callback>>* = nullptr>
+    Future schedule(Graph &graph, Callback &&onComplete) { return schedule(graph, NoDeadline, std::forward<Callback>(onComplete)); }
+
+    /** @brief Schedule a graph of tasks that must complete before 'deadline' (real-time mode)
+     *  While a deadline graph is in flight, idle workers spin instead of parking
+     *  A late run is counted, its first late node is recorded and the deadline policy is applied to its remaining nodes */
+    Future schedule(Graph &graph, const Deadline deadline) { return schedule(graph, deadline, nullptr); }
 
-    /** @brief Schedule a task */
+    template<typename Callback>
+    Future schedule(Graph &graph, const Deadline deadline, Callback &&onComplete);
+
+    /** @brief Schedule a task submitted from outside a worker, workers are selected in round-robin */
     void schedule(const Task task) noexcept;
 
-    /** @brief Tries to steal a task from a busy worker (only used by workers) */
-    [[nodiscard]] bool steal(Task &task) noexcept;
+    /** @brief Schedule a task on a given worker, it may still be stolen by another one
+     *  The worker is always woken up, even while another one is searching for work */
+    void schedule(const Task task, const std::size_t workerIndex) noexcept;
+
+    /** @brief Schedule a task from the work of a running node
+     *  The task is pushed into the calling worker's queue, or scheduled in round-robin when called outside of this scheduler's workers */
+    void spawn(const Task task) noexcept;
+
+    /** @brief Schedule a batch of tasks submitted from outside a worker
+     *  The batch is split over consecutive workers in round-robin, each worker's inbox is locked and woken up once */
+    void schedule(const Task * const begin, const Task * const end) noexcept;
+
+    /** @brief Wake up a single IDLE worker if there is any and if no worker is searching for work, used when a worker pushes tasks into its own queue */
+    void wakeUpIdleWorker(void) noexcept;
+
+    /** @brief Tries to steal a task from a busy worker (only used by workers)
+     *  Victims are visited by increasing CPU distance, starting from a random worker of each distance, and the thief never steals from itself */
+    [[nodiscard]] bool steal(Worker &thief, Task &task) noexcept;
+
+    /** @brief Get / Set the steal policy (setting it while the scheduler is running is racy) */
+    [[nodiscard]] const StealPolicy &stealPolicy(void) const noexcept { return _cache.stealPolicy; }
+    void setStealPolicy(const StealPolicy &policy) noexcept { _cache.stealPolicy = policy; }
+
+    /** @brief Process all pending notifications on the current thread, returns the number of processed notifications
+     *  Each worker queues its notifications on its own, they are drained worker by worker in batches
+     *  An exception thrown by a notification is propagated, the following notifications are processed by the next call
+     *  Only a single thread may process notifications at a time */
+    std::size_t processNotifications(void);
+
+    /** @brief Get / Set the notification overflow policy (setting it while the scheduler is running is racy)
+     *  Workers never wait for the event thread: a full queue either grows, coalesces pending nodes or drops its oldest notification */
+    [[nodiscard]] NotificationPolicy notificationPolicy(void) const noexcept { return _cache.notificationPolicy; }
+    void setNotificationPolicy(const NotificationPolicy policy) noexcept { _cache.notificationPolicy = policy; }
+
+    /** @brief Create a file descriptor that becomes readable when notifications are pending, to be registered in a poll / epoll loop
+     *  Signals are coalesced: the handle is signalled once until the next call to 'processNotifications', which resets it
+     *  Only supported on Linux (eventfd), enabling or disabling the handle while the scheduler is running is racy */
+    int enableNotificationHandle(void);
+
+    /** @brief Close the notification handle */
+    void disableNotificationHandle(void) noexcept;
+
+    /** @brief Get the notification handle, InvalidNotificationHandle if disabled */
+    [[nodiscard]] int notificationHandle(void) const noexcept { return _cache.notificationHandle; }
+
+    /** @brief Get / Set the deadline policy (setting it while a deadline graph is running is racy) */
+    [[nodiscard]] DeadlinePolicy deadlinePolicy(void) const noexcept { return _cache.deadlinePolicy; }
+    void setDeadlinePolicy(const DeadlinePolicy policy) noexcept { _cache.deadlinePolicy = policy; }
+
+    /** @brief Get the number of graph runs that missed their deadline */
+    [[nodiscard]] std::size_t deadlineMissCount(void) const noexcept { return _deadlineMisses.load(std::memory_order_relaxed); }
+
+    /** @brief Get the first late node of the last graph run that missed its deadline (invalid if none)
+     *  The task remains valid as long as its graph lives */
+    [[nodiscard]] Task lastDeadlineMiss(void) const noexcept { return Task(_lastDeadlineMiss.load(std::memory_order_relaxed)); }
 
-    /** @brief Tries to add a notification task to be executed on the event processing thread */
-    [[nodiscard]] bool notify(const Task task) noexcept { return _notifications.push(task); }
+    /** @brief Check if at least one deadline graph is in flight */
+    [[nodiscard]] bool hasDeadlineGraphs(void) const noexcept { return _deadlineGraphs.load(std::memory_order_relaxed); }
 
-    /** @brief Process all pending notifications on the current thread */
-    void processNotifications(void) { for (Task task; _notifications.pop(task); task.node()->notifyFunc()); }
+    /** @brief Enable node execution tracing, each worker keeps its last 'capacity' events in its own ring buffer
+     *  Enabling or disabling tracing while a graph is running is racy
+     *  It has no effect if FLOW_DISABLE_TRACING is defined: no buffer is allocated and 'tracingEnabled' stays false */
+    void enableTracing(const std::size_t capacity = TraceBuffer::DefaultCapacity);
 
-    /** @brief All job to be terminated */
-    void wait(void) noexcept;
+    /** @brief Disable tracing and release every trace buffer */
+    void disableTracing(void) noexcept;
+
+    /** @brief Check if tracing is enabled */
+    [[nodiscard]] bool tracingEnabled(void) const noexcept { return !_cache.traceBuffers.empty(); }
+
+    /** @brief Get the trace buffer of a worker (tracing must be enabled) */
+    [[nodiscard]] const TraceBuffer &traceBuffer(const std::size_t workerIndex) const noexcept { return _cache.traceBuffers[workerIndex]; }
+
+    /** @brief Export the trace of every worker as Chrome trace JSON (only consistent while no graph is running) */
+    void exportTrace(std::ostream &stream) const
+        { TraceBuffer::ExportChromeTrace(stream, _cache.traceBuffers.begin(), _cache.traceBuffers.end()); }
+
+    /** @brief Get a snapshot of the runtime counters of every worker
+     *  Counters are updated with relaxed atomics, so a snapshot taken while graphs are running is only approximately consistent */
+    [[nodiscard]] SchedulerStats stats(void) const;
+
+    /** @brief Publish the CPU a starting worker is pinned to (NoCpu if none), then wait until every worker is started (only used by workers) */
+    void workerStarted(const std::size_t workerIndex, const std::uint32_t cpu) noexcept;
+
+    /** @brief Track the number of IDLE workers (only used by workers) */
+    void workerParked(void) noexcept { _idleCount.fetch_add(1); }
+    void workerUnparked(void) noexcept { _idleCount.fetch_sub(1, std::memory_order_relaxed); }
+
+    /** @brief Track the number of workers searching for work (only used by workers)
+     *  Submitters skip their wake-up while a worker is searching, the last one to stop searching must check every queue once more */
+    void workerStartedSearching(void) noexcept { _searchingCount.fetch_add(1u, std::memory_order_relaxed); }
+    [[nodiscard]] bool workerStoppedSearching(void) noexcept { return _searchingCount.fetch_sub(1u) == 1u; }
+
+    /** @brief Stop searching unless the steal policy keeps the last searcher while a worker is parked, returns false if the worker must keep searching
+     *  'last' is set if the worker was the last one searching (only used by workers) */
+    [[nodiscard]] bool workerTryStopSearching(bool &last) noexcept;
+
+    /** @brief Check if a parking worker must search instead, as the steal policy keeps a searcher while other workers are parked (only used by workers) */
+    [[nodiscard]] bool lacksSearchingWorker(void) const noexcept;
+
+    /** @brief Get the number of workers searching for work */
+    [[nodiscard]] std::size_t searchingWorkerCount(void) const noexcept { return _searchingCount.load(std::memory_order_relaxed); }
+
+    /** @brief Get the number of parked workers */
+    [[nodiscard]] std::size_t idleWorkerCount(void) const noexcept { return _idleCount.load(std::memory_order_relaxed); }
+
+    /** @brief Block the current thread until every scheduled graph is completed
+     *  Only graph runs are tracked, tasks scheduled on their own are not waited for */
+    void waitGraphs(void) const noexcept;
+
+    /** @brief Block the current thread until every scheduled graph is completed or the timeout is reached, returns false on timeout */
+    template<typename Rep, typename Period>
+    [[nodiscard]] bool waitGraphsFor(const std::chrono::duration<Rep, Period> &duration) const noexcept
+        { return waitGraphsUntil(std::chrono::steady_clock::now() + duration); }
+
+    template<typename Clock, typename Duration>
+    [[nodiscard]] bool waitGraphsUntil(const std::chrono::time_point<Clock, Duration> &timeout) const noexcept;
 
     /** @brief Get the count of worker */
     [[nodiscard]] std::size_t workerCount(void) const noexcept { return _cache.workers.size(); }
 
+    /** @brief Get the CPU a worker is pinned to, NoCpu if it isn't pinned or if pinning failed */
+    [[nodiscard]] std::uint32_t workerCpu(const std::size_t workerIndex) const noexcept { return _cache.workerCpus[workerIndex]; }
+
+    /** @brief Get the steal victims of a worker, by increasing CPU distance */
+    [[nodiscard]] std::vector<std::size_t> stealOrder(const std::size_t workerIndex) const;
+
+    /** @brief Get the index of a worker */
+    [[nodiscard]] std::size_t workerIndex(const Worker &worker) const noexcept
+        { return static_cast<std::size_t>(&worker - _cache.workers.begin()); }
+
+public:
+    /** @brief Schedule again the root nodes of a running graph
+     *  Reserved for internal use ! */
+    void repeat(Graph &graph) noexcept;
+
+    /** @brief Release the deadline of a graph about to complete
+     *  Reserved for internal use ! */
+    void deadlineCompleted(void) noexcept { _deadlineGraphs.fetch_sub(1u, std::memory_order_relaxed); }
+
+    /** @brief Count a wake-up issued from a thread outside of the scheduler
+     *  Reserved for internal use ! */
+    void externalWakeUpIssued(void) noexcept { _externalWakeUps.fetch_add(1u, std::memory_order_relaxed); }
+
+    /** @brief Signal the notification handle if enabled and not already signalled, called after a notification is queued
+     *  Reserved for internal use ! */
+    void notificationQueued(void) noexcept
+        { if (_cache.notificationHandle != InvalidNotificationHandle && !_notificationSignalled.exchange(true)) signalNotificationHandle(); }
+
+    /** @brief Callback of a completed graph
+     *  Reserved for internal use ! */
+    void graphCompleted(void) noexcept;
+
+    /** @brief Check the deadline of a node's graph before and once the node is executed, returns true if the deadline is missed
+     *  Reserved for internal use ! */
+    bool checkDeadline(Node * const node) noexcept;
+
 private:
+    /** @brief Allocate and start workers, which pin themselves to their CPUs, then build their steal order from the CPUs actually pinned
+     *  An empty 'cpus' list leaves workers unpinned, 'allowed' is the CPU set of unpinned workers (empty for no restriction) */
+    void startWorkers(const std::size_t workerCount, const std::size_t notificationQueueSize,
+            const std::vector<CpuInfo> &cpus, const std::vector<std::uint32_t> &allowed, const bool hierarchicalSteal);
+
+    /** @brief Reserve 'count' consecutive workers in round-robin, returns the index of the first one */
+    [[nodiscard]] std::size_t reserveWorkers(const std::size_t count) noexcept;
+
+    /** @brief Value of the starting workers count once workers may run */
+    static constexpr std::size_t WorkersReady { ~static_cast<std::size_t>(0) };
+
+    /** @brief Write into the notification handle */
+    void signalNotificationHandle(void) noexcept;
+
     struct Cache
     {
         Core::HeapArray<Worker> workers {};
+        Core::HeapArray<TraceBuffer> traceBuffers {};
+        Core::HeapArray<NotificationQueue> notificationQueues {};
+        Core::HeapArray<std::uint32_t> workerCpus {};
+        Core::HeapArray<std::uint32_t> victims {}; // Steal victims of each worker ('workerCount - 1' per worker) by increasing distance
+        Core::HeapArray<std::uint32_t> victimRanges {}; // End of each distance in the victims of each worker ('CpuDistanceCount' per worker)
+        StealPolicy stealPolicy {};
+        DeadlinePolicy deadlinePolicy { DeadlinePolicy::Continue };
+        NotificationPolicy notificationPolicy { NotificationPolicy::Grow };
+        int notificationHandle { InvalidNotificationHandle };
     };
 
     alignas_cacheline Cache _cache {};
     alignas_cacheline std::atomic<std::size_t> _lastWorkerId { 0 };
-    Core::MPMCQueue<Task> _notifications;
+    alignas_cacheline std::atomic<std::size_t> _idleCount { 0 };
+    alignas_cacheline std::atomic<std::size_t> _searchingCount { 0 };
+    alignas_cacheline std::atomic<std::size_t> _activeGraphs { 0 };
+    alignas_cacheline std::atomic<std::size_t> _deadlineGraphs { 0 };
+    alignas_cacheline std::atomic<std::size_t> _deadlineMisses { 0 };
+    std::atomic<Node *> _lastDeadlineMiss { nullptr };
+    alignas_cacheline std::atomic<std::uint64_t> _externalWakeUps { 0u };
+    alignas_cacheline std::atomic<bool> _notificationSignalled { false };
+    std::atomic<std::size_t> _startingWorkers { 0 }; // Workers not yet pinned while starting, 'WorkersReady' once their steal order is built
 };
 
 #include "Scheduler.ipp"
-#include "Worker.ipp"
\ No newline at end of file
+#include "Worker.ipp"
+#include "Coroutine.ipp"
\ No newline at end of file
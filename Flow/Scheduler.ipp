@@ -3,41 +3,146 @@
  * @ Description: Scheduler
  */
 
-template<bool IsRepeating>
-inline void Flow::Scheduler::schedule(Graph &graph)
-{
-    if constexpr (!IsRepeating) {
-        graph.preprocess();
-        if (graph.running())
-            throw std::logic_error("Flow::Scheduler::schedule: Can't schedule a graph if it is already running");
-        graph.setRunning(true);
-        graph.setScheduler(this);
+inline Flow::Future Flow::Scheduler::schedule(Graph &graph)
+{
+    return schedule(graph, NoDeadline, nullptr);
+}
+
+template<typename Callback>
+inline Flow::Future Flow::Scheduler::schedule(Graph &graph, const Deadline deadline, Callback &&onComplete)
+{
+    if (!graph || !graph.size()) {
+        if constexpr (!std::is_null_pointer_v<std::remove_cvref_t<Callback>>)
+            onComplete();
+        return Future();
     }
-    for (auto &child : graph) {
-        if (child->linkedFrom.empty())
-            schedule(Task(child.node()));
+    graph.preprocess();
+    if (graph.running())
+        throw std::logic_error("Flow::Scheduler::schedule: Can't schedule a graph if it is already running");
+    if constexpr (!std::is_null_pointer_v<std::remove_cvref_t<Callback>>)
+        graph.setCompleteCallback(std::forward<Callback>(onComplete));
+    _activeGraphs.fetch_add(1u, std::memory_order_relaxed);
+    graph.setDeadline(deadline);
+    if (deadline != NoDeadline && !_deadlineGraphs.fetch_add(1u, std::memory_order_relaxed)) {
+        // Wake up parked workers so they stay hot during the whole run
+        for (auto &worker : _cache.workers)
+            worker.tryWakeUp();
     }
+    graph.setScheduler(this);
+    Future future(graph, graph.startRun());
+    repeat(graph);
+    return future;
+}
+
+inline void Flow::Scheduler::repeat(Graph &graph) noexcept
+{
+    if (const auto compiled = graph.compiled(); compiled && compiled->staticSchedule) {
+        compiled->prepareStaticRun(static_cast<std::uint32_t>(workerCount()));
+        for (const auto index : compiled->staticSchedule->heads)
+            schedule(Task(compiled->nodes[index]), compiled->staticSchedule->workers[index]);
+        return;
+    }
+    const auto &roots = graph.roots();
+    schedule(roots.begin(), roots.end());
+}
+
+inline void Flow::Scheduler::graphCompleted(void) noexcept
+{
+    if (_activeGraphs.fetch_sub(1u, std::memory_order_acq_rel) == 1u)
+        atomic_sync::atomic_notify_all(&_activeGraphs);
+}
+
+inline bool Flow::Scheduler::checkDeadline(Node * const node) noexcept
+{
+    if (DeadlineClock::now() <= node->root->deadline())
+        return false;
+    if (node->root->markDeadlineMissed()) {
+        _deadlineMisses.fetch_add(1u, std::memory_order_relaxed);
+        _lastDeadlineMiss.store(node, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+template<typename Clock, typename Duration>
+inline bool Flow::Scheduler::waitGraphsUntil(const std::chrono::time_point<Clock, Duration> &timeout) const noexcept
+{
+    for (auto count = _activeGraphs.load(std::memory_order_acquire); count; count = _activeGraphs.load(std::memory_order_acquire)) {
+        if (!AtomicWaitUntil(_activeGraphs, count, timeout))
+            return false;
+    }
+    return true;
 }
 
 inline void Flow::Scheduler::schedule(const Task task) noexcept
 {
-    const auto count = workerCount();
+    auto &worker = _cache.workers[reserveWorkers(1)];
+
+    worker.submit(task);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    // A searching worker steals the task from the inbox without any wake-up
+    if (!_searchingCount.load(std::memory_order_relaxed))
+        worker.tryWakeUp();
+}
+
+inline std::size_t Flow::Scheduler::reserveWorkers(const std::size_t count) noexcept
+{
+    const auto workers = workerCount();
     auto id = _lastWorkerId.load(std::memory_order_relaxed);
-    std::size_t targetId;
+    std::size_t lastId;
 
     while (true) {
-        while (true) {
-            targetId = id + 1;
-            if (targetId == count)
-                targetId = 0;
-            if (_lastWorkerId.compare_exchange_weak(id, targetId, std::memory_order_relaxed))
-                break;
-        }
-        auto &worker = _cache.workers[targetId];
-        if (worker.push(task)) {
-            if (worker.state() == Worker::State::IDLE)
-                worker.wakeUp(Worker::State::Running);
+        lastId = id + count;
+        if (lastId >= workers)
+            lastId -= workers;
+        if (_lastWorkerId.compare_exchange_weak(id, lastId, std::memory_order_relaxed))
             break;
-        }
+    }
+    return id + 1 == workers ? 0 : id + 1;
+}
+
+inline void Flow::Scheduler::schedule(const Task task, const std::size_t workerIndex) noexcept
+{
+    auto &worker = _cache.workers[workerIndex];
+
+    worker.submit(task);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    worker.tryWakeUp();
+}
+
+inline void Flow::Scheduler::spawn(const Task task) noexcept
+{
+    if (const auto worker = Worker::Current(); worker && worker->parent() == this) {
+        worker->push(task);
+        wakeUpIdleWorker();
+    } else
+        schedule(task);
+}
+
+inline bool Flow::Scheduler::workerTryStopSearching(bool &last) noexcept
+{
+    auto count = _searchingCount.load(std::memory_order_relaxed);
+
+    do {
+        if (count == 1u && _cache.stealPolicy.keepSearching && _idleCount.load(std::memory_order_relaxed))
+            return false;
+    } while (!_searchingCount.compare_exchange_weak(count, count - 1u));
+    last = count == 1u;
+    return true;
+}
+
+inline bool Flow::Scheduler::lacksSearchingWorker(void) const noexcept
+{
+    // The caller is already counted as parked
+    return _cache.stealPolicy.keepSearching && !_searchingCount.load(std::memory_order_relaxed) && _idleCount.load(std::memory_order_relaxed) > 1u;
+}
+
+inline void Flow::Scheduler::wakeUpIdleWorker(void) noexcept
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_searchingCount.load(std::memory_order_relaxed) || !_idleCount.load(std::memory_order_relaxed))
+        return;
+    for (auto &worker : _cache.workers) {
+        if (worker.tryWakeUp())
+            return;
     }
 }
\ No newline at end of file
@@ -0,0 +1,193 @@
+/**
+ * @ Author: Matthieu Moinvaziri
+ * @ Description: Compile-time typed task graph
+ */
+
+#pragma once
+
+#include <array>
+#include <tuple>
+#include <utility>
+
+#include "Scheduler.hpp"
+
+namespace Flow
+{
+    /** @brief List of node callable types of a static graph, each type must be unique */
+    template<typename ...Nodes>
+    struct StaticNodes {};
+
+    /** @brief Edge of a static graph, 'To' is executed after 'From' */
+    template<typename From, typename To>
+    struct StaticEdge {};
+
+    /** @brief List of edges of a static graph */
+    template<typename ...Edges>
+    struct StaticEdges {};
+
+    /** @brief Extract the node types of an edge */
+    template<typename Edge>
+    struct StaticEdgeTraits;
+
+    template<typename EdgeFrom, typename EdgeTo>
+    struct StaticEdgeTraits<StaticEdge<EdgeFrom, EdgeTo>>
+    {
+        using From = EdgeFrom;
+        using To = EdgeTo;
+    };
+
+    template<typename Nodes, typename Edges>
+    class StaticGraph;
+}
+
+/**
+ * @brief Task graph whose topology is known at compile time
+ *  Each node is a callable type and each edge a StaticEdge of two node types
+ *  Join counts and successor lists are compile-time constants: executing a node inlines its callable,
+ *  its successors join counters and then continues with the first ready successor through a flat function table
+ *  Other ready successors are spawned on the Scheduler workers through proxy tasks of an internal graph
+ *
+ * @example
+ *  using Pipeline = Flow::StaticGraph<
+ *      Flow::StaticNodes<Decode, Mix, Output>,
+ *      Flow::StaticEdges<Flow::StaticEdge<Decode, Mix>, Flow::StaticEdge<Mix, Output>>
+ *  >;
+ *  Pipeline pipeline(Decode {}, Mix {}, Output {});
+ *  scheduler.schedule(pipeline.graph()).wait();
+ */
+template<typename ...Nodes, typename ...Edges>
+class Flow::StaticGraph<Flow::StaticNodes<Nodes...>, Flow::StaticEdges<Edges...>>
+{
+public:
+    /** @brief Number of nodes */
+    static constexpr std::size_t NodeCount { sizeof...(Nodes) };
+
+    /** @brief Number of edges */
+    static constexpr std::size_t EdgeCount { sizeof...(Edges) };
+
+    static_assert(NodeCount > 0ul, "Flow::StaticGraph: Graph must have at least one node");
+
+    /** @brief Index of a node type */
+    template<typename Node>
+    static constexpr std::size_t IndexOf = [] {
+        constexpr bool matches[] { std::is_same_v<Node, Nodes>... };
+        std::size_t index = NodeCount;
+        for (auto i = 0ul; i < NodeCount; ++i) {
+            if (matches[i])
+                index = index == NodeCount ? i : NodeCount + 1ul;
+        }
+        return index;
+    }();
+
+    /** @brief Construct the graph with default constructed nodes */
+    StaticGraph(void) : StaticGraph(Nodes {}...) {}
+
+    /** @brief Construct the graph with node instances */
+    StaticGraph(Nodes ...nodes);
+
+    /** @brief Static graphs can't be copied nor moved as their proxy tasks reference them */
+    StaticGraph(const StaticGraph &other) = delete;
+    StaticGraph &operator=(const StaticGraph &other) = delete;
+
+    /** @brief Destroy the graph once its run is completed */
+    ~StaticGraph(void) { _graph.waitCompletion(); }
+
+    /** @brief Get the graph to schedule on a Scheduler */
+    [[nodiscard]] Graph &graph(void) noexcept { return _graph; }
+
+    /** @brief Get a node instance */
+    template<typename Node>
+    [[nodiscard]] Node &get(void) noexcept { return std::get<IndexOf<Node>>(_nodes); }
+
+private:
+    /** @brief Index of an absent node */
+    static constexpr std::size_t NoIndex { ~0ul };
+
+    static_assert(((IndexOf<Nodes> < NodeCount) && ...), "Flow::StaticGraph: Each node type must be unique");
+    static_assert(((IndexOf<typename StaticEdgeTraits<Edges>::From> < NodeCount && IndexOf<typename StaticEdgeTraits<Edges>::To> < NodeCount) && ...),
+        "Flow::StaticGraph: Edge references an unknown node");
+
+    /** @brief List of edges as node index pairs */
+    static constexpr std::array<std::pair<std::size_t, std::size_t>, EdgeCount> EdgeList {
+        std::pair<std::size_t, std::size_t> { IndexOf<typename StaticEdgeTraits<Edges>::From>, IndexOf<typename StaticEdgeTraits<Edges>::To> }...
+    };
+
+    /** @brief Number of predecessors of each node */
+    static constexpr auto JoinCounts = [] {
+        std::array<std::uint32_t, NodeCount> joinCounts {};
+        for (const auto &edge : EdgeList)
+            ++joinCounts[edge.second];
+        return joinCounts;
+    }();
+
+    /** @brief Successors of each node in CSR form */
+    static constexpr auto SuccessorOffsets = [] {
+        std::array<std::size_t, NodeCount + 1ul> offsets {};
+        for (const auto &edge : EdgeList)
+            ++offsets[edge.first + 1ul];
+        for (auto i = 0ul; i < NodeCount; ++i)
+            offsets[i + 1ul] += offsets[i];
+        return offsets;
+    }();
+    static constexpr auto Successors = [] {
+        std::array<std::size_t, EdgeCount + 1ul> successors {};
+        auto cursors = SuccessorOffsets;
+        for (const auto &edge : EdgeList)
+            successors[cursors[edge.first]++] = edge.second;
+        return successors;
+    }();
+
+    /** @brief Check that the graph is acyclic */
+    static constexpr bool IsAcyclic = [] {
+        auto pendings = JoinCounts;
+        std::array<std::size_t, NodeCount> order {};
+        std::size_t size = 0ul;
+        for (auto i = 0ul; i < NodeCount; ++i) {
+            if (!pendings[i])
+                order[size++] = i;
+        }
+        for (auto i = 0ul; i < size; ++i) {
+            for (auto j = SuccessorOffsets[order[i]]; j < SuccessorOffsets[order[i] + 1ul]; ++j) {
+                if (!--pendings[Successors[j]])
+                    order[size++] = Successors[j];
+            }
+        }
+        return size == NodeCount;
+    }();
+
+    static_assert(IsAcyclic, "Flow::StaticGraph: Graph must be acyclic");
+
+    /** @brief Function executing a node then returning its ready continuation */
+    using ExecuteFunc = std::size_t(*)(StaticGraph &);
+
+    std::tuple<Nodes...> _nodes;
+    std::array<std::atomic<std::uint32_t>, NodeCount> _joined {};
+    std::array<Task, NodeCount> _proxies {};
+    Graph _graph {};
+
+    /** @brief Execute a node from its proxy task, then its ready continuations */
+    template<std::size_t Index>
+    void run(void);
+
+    /** @brief Execute a node and join its successors, returns the first ready successor or NoIndex */
+    template<std::size_t Index>
+    [[nodiscard]] static std::size_t Execute(StaticGraph &graph);
+
+    /** @brief Execute a node through the flat table of every node, returns its ready continuation */
+    template<std::size_t ...Indexes>
+    [[nodiscard]] static std::size_t Dispatch(StaticGraph &graph, const std::size_t index, std::index_sequence<Indexes...>);
+
+    /** @brief Join the successors of a node */
+    template<std::size_t Index, std::size_t ...Offsets>
+    void joinSuccessors(std::size_t &next, std::index_sequence<Offsets...>) noexcept;
+
+    /** @brief Join a single node, the first ready node becomes 'next' and the others are spawned */
+    template<std::size_t Index>
+    void join(std::size_t &next) noexcept;
+
+    /** @brief Emplace proxy tasks and link them like the edges of the graph */
+    template<std::size_t ...Indexes>
+    void buildProxies(std::index_sequence<Indexes...>);
+};
+
+#include "StaticGraph.ipp"
@@ -0,0 +1,87 @@
+/**
+ * @ Author: Matthieu Moinvaziri
+ * @ Description: Compile-time typed task graph
+ */
+
+template<typename ...Nodes, typename ...Edges>
+inline Flow::StaticGraph<Flow::StaticNodes<Nodes...>, Flow::StaticEdges<Edges...>>::StaticGraph(Nodes ...nodes)
+    : _nodes(std::move(nodes)...)
+{
+    buildProxies(std::make_index_sequence<NodeCount>());
+}
+
+template<typename ...Nodes, typename ...Edges>
+template<std::size_t ...Indexes>
+inline void Flow::StaticGraph<Flow::StaticNodes<Nodes...>, Flow::StaticEdges<Edges...>>::buildProxies(std::index_sequence<Indexes...>)
+{
+    // Proxies are linked like any graph but join their successors themselves, they can't be bypassed as successors would never be joined
+    ((_proxies[Indexes] = _graph.emplace([this] { run<Indexes>(); })), ...);
+    ((_proxies[Indexes].setCritical(true)), ...);
+    for (const auto &edge : EdgeList)
+        _proxies[edge.first].precede(_proxies[edge.second]);
+    _graph.setSelfJoined();
+    _graph.preprocess();
+}
+
+template<typename ...Nodes, typename ...Edges>
+template<std::size_t Index>
+inline void Flow::StaticGraph<Flow::StaticNodes<Nodes...>, Flow::StaticEdges<Edges...>>::run(void)
+{
+    auto next = Execute<Index>(*this);
+
+    // The proxy node is joined by the worker, its continuations are joined here
+    while (next != NoIndex) {
+        next = Dispatch(*this, next, std::make_index_sequence<NodeCount>());
+        _graph.childJoined();
+    }
+}
+
+template<typename ...Nodes, typename ...Edges>
+template<std::size_t Index>
+inline std::size_t Flow::StaticGraph<Flow::StaticNodes<Nodes...>, Flow::StaticEdges<Edges...>>::Execute(StaticGraph &graph)
+{
+    std::size_t next = NoIndex;
+
+    // Nodes of a cancelled or failed run only join their successors so that the run completes
+    if (!graph._graph.cancelled()) {
+        try {
+            std::get<Index>(graph._nodes)();
+        } catch (...) {
+            graph._graph.fail(std::current_exception());
+        }
+    }
+    graph.template joinSuccessors<Index>(next, std::make_index_sequence<SuccessorOffsets[Index + 1ul] - SuccessorOffsets[Index]>());
+    return next;
+}
+
+template<typename ...Nodes, typename ...Edges>
+template<std::size_t ...Indexes>
+inline std::size_t Flow::StaticGraph<Flow::StaticNodes<Nodes...>, Flow::StaticEdges<Edges...>>::Dispatch(
+        StaticGraph &graph, const std::size_t index, std::index_sequence<Indexes...>)
+{
+    static constexpr ExecuteFunc Table[] { &Execute<Indexes>... };
+
+    return Table[index](graph);
+}
+
+template<typename ...Nodes, typename ...Edges>
+template<std::size_t Index, std::size_t ...Offsets>
+inline void Flow::StaticGraph<Flow::StaticNodes<Nodes...>, Flow::StaticEdges<Edges...>>::joinSuccessors(std::size_t &next, std::index_sequence<Offsets...>) noexcept
+{
+    (join<Successors[SuccessorOffsets[Index] + Offsets]>(next), ...);
+}
+
+template<typename ...Nodes, typename ...Edges>
+template<std::size_t Index>
+inline void Flow::StaticGraph<Flow::StaticNodes<Nodes...>, Flow::StaticEdges<Edges...>>::join(std::size_t &next) noexcept
+{
+    if constexpr (JoinCounts[Index] != 1u) {
+        if (++_joined[Index] != JoinCounts[Index])
+            return;
+        _joined[Index] = 0u;
+    }
+    if (next == NoIndex)
+        next = Index;
+    else
+        _graph.scheduler()->spawn(_proxies[Index]);
+}
@@ -0,0 +1,26 @@
+/**
+ * @ Author: Matthieu Moinvaziri
+ * @ Description: Scheduler runtime statistics
+ */
+
+#include "Stats.hpp"
+
+Flow::WorkerStats Flow::SchedulerStats::total(void) const noexcept
+{
+    WorkerStats total;
+
+    for (const auto &worker : workers) {
+        total.tasksExecuted += worker.tasksExecuted;
+        total.localPops += worker.localPops;
+        total.steals += worker.steals;
+        total.failedSteals += worker.failedSteals;
+        total.wakeUpsIssued += worker.wakeUpsIssued;
+        total.wakeUpsReceived += worker.wakeUpsReceived;
+        total.inboxRetries += worker.inboxRetries;
+        total.notificationsCoalesced += worker.notificationsCoalesced;
+        total.notificationsDropped += worker.notificationsDropped;
+        total.parkedTime += worker.parkedTime;
+        total.runningTime += worker.runningTime;
+    }
+    return total;
+}
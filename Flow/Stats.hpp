@@ -0,0 +1,72 @@
+/**
+ * @ Author: Matthieu Moinvaziri
+ * @ Description: Scheduler runtime statistics
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include <Core/Utils.hpp>
+
+namespace Flow
+{
+    struct WorkerStats;
+    struct SchedulerStats;
+    struct WorkerCounters;
+}
+
+/** @brief Snapshot of the counters of a single worker */
+struct Flow::WorkerStats
+{
+    std::uint64_t tasksExecuted { 0u }; // Number of executed tasks, continuations included
+    std::uint64_t localPops { 0u }; // Tasks popped from the worker's own queue or inbox
+    std::uint64_t steals { 0u }; // Successful steals from other workers
+    std::uint64_t failedSteals { 0u }; // Steal passes over every other worker that found nothing
+    std::uint64_t wakeUpsIssued { 0u }; // IDLE workers woken up by this worker
+    std::uint64_t wakeUpsReceived { 0u }; // Times this worker was woken up after parking
+    std::uint64_t inboxRetries { 0u }; // Spins of submitting threads on the contended inbox lock of this worker
+    std::uint64_t notificationsCoalesced { 0u }; // Notifications merged into a pending one of the same node
+    std::uint64_t notificationsDropped { 0u }; // Pending notifications overwritten by a push into a full queue
+    std::chrono::nanoseconds parkedTime {}; // Time spent parked
+    std::chrono::nanoseconds runningTime {}; // Time spent out of park since the worker started
+};
+
+/** @brief Snapshot of the counters of every worker of a scheduler */
+struct Flow::SchedulerStats
+{
+    std::vector<WorkerStats> workers {}; // Counters of each worker
+    std::uint64_t externalWakeUps { 0u }; // IDLE workers woken up from threads outside of the scheduler
+
+    /** @brief Get the sum of every worker counters */
+    [[nodiscard]] WorkerStats total(void) const noexcept;
+};
+
+/**
+ * @brief Live counters of a worker, only written by their owner worker
+ *  Counters are relaxed atomics incremented without read-modify-write so that readers never observe torn values
+ */
+struct alignas_cacheline Flow::WorkerCounters
+{
+    std::atomic<std::uint64_t> tasksExecuted { 0u };
+    std::atomic<std::uint64_t> localPops { 0u };
+    std::atomic<std::uint64_t> steals { 0u };
+    std::atomic<std::uint64_t> failedSteals { 0u };
+    std::atomic<std::uint64_t> wakeUpsIssued { 0u };
+    std::atomic<std::uint64_t> wakeUpsReceived { 0u };
+    std::atomic<std::uint64_t> notificationsCoalesced { 0u };
+    std::atomic<std::uint64_t> notificationsDropped { 0u };
+    std::atomic<std::int64_t> parkedNanoseconds { 0 };
+    std::atomic<std::int64_t> runningNanoseconds { 0 }; // Running time up to the last park
+    std::atomic<std::int64_t> activeSince { 0 }; // Timestamp of the last unpark in nanoseconds, 0 while parked
+
+    /** @brief Increment a counter (only the owner worker may call this) */
+    template<typename Type>
+    static void Increment(std::atomic<Type> &counter, const Type value = 1) noexcept
+        { counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed); }
+};
+
+static_assert_fit_double_cacheline(Flow::WorkerCounters);
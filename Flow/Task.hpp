@@ -76,10 +76,20 @@ public:
     [[nodiscard]] std::string_view name(void) const noexcept;
     void setName(const std::string_view &name) noexcept;
 
-    /** @brief Get / Set the name property */
+    /** @brief Get / Set the bypass property */
     [[nodiscard]] bool bypass(void) const noexcept;
     void setBypass(const bool &bypass) noexcept;
 
+    /** @brief Get / Set the critical property, a critical task is never bypassed when its graph misses its deadline */
+    [[nodiscard]] bool critical(void) const noexcept;
+    void setCritical(const bool critical) noexcept;
+
+    /** @brief Get the effective priority, only computed on preprocess for an automatic priority */
+    [[nodiscard]] Priority priority(void) const noexcept;
+
+    /** @brief Set the priority, 'Priority::Auto' derives it from the critical path of the task's graph */
+    void setPriority(const Priority priority) noexcept;
+
     /** @brief Add a task linked to this instance */
     Task &precede(Task &task) noexcept;
 
@@ -12,7 +12,20 @@ inline Flow::NodeType Flow::Task::type(void) const noexcept
 template<typename Work>
 inline void Flow::Task::setWork(Work &&work) noexcept
 {
-    _node->workData = Node::ForwardWorkData(std::forward<Work>(work));
+    Node::WorkData workData(Node::ForwardWorkData(std::forward<Work>(work)));
+
+    // The functor of a compiled static node is stored by its compiled graph, changing the type of a node drops the compiled form
+    if (const auto compiled = _node->root->compiled(); compiled) {
+        if (workData.index() == _node->workData.index() && type() == NodeType::Static) {
+            compiled->staticWorks[_node->index] = std::move(std::get<static_cast<std::size_t>(NodeType::Static)>(workData));
+            return;
+        } else if (workData.index() != _node->workData.index())
+            _node->root->invalidateIncrementally();
+    }
+    _node->workData = std::move(workData);
+    // A new switch node needs the join counts of its branches
+    if (type() == NodeType::Switch)
+        _node->root->invalidateIncrementally(_node);
 }
 
 inline bool Flow::Task::hasNotification(void) const noexcept
@@ -60,9 +73,37 @@ inline void Flow::Task::setBypass(const bool &bypass) noexcept
     _node->bypass.store(bypass);
 }
 
+inline bool Flow::Task::critical(void) const noexcept
+{
+    return _node->critical;
+}
+
+inline void Flow::Task::setCritical(const bool critical) noexcept
+{
+    _node->critical = critical;
+}
+
+inline Flow::Priority Flow::Task::priority(void) const noexcept
+{
+    return _node->level;
+}
+
+inline void Flow::Task::setPriority(const Priority priority) noexcept
+{
+    _node->priority = priority;
+    if (priority != Priority::Auto)
+        _node->level = priority;
+    else
+        _node->root->invalidateIncrementally();
+}
+
 inline Flow::Task &Flow::Task::precede(Task &task) noexcept
 {
     _node->linkedTo.push(task._node);
     task._node->linkedFrom.push(_node);
+    // Only the switch nodes reaching the source of the link may reach more nodes
+    _node->root->invalidateIncrementally(_node);
+    if (task._node->root != _node->root)
+        task._node->root->invalidateIncrementally();
     return *this;
 }
\ No newline at end of file
@@ -0,0 +1,153 @@
+/**
+ * @ Author: Matthieu Moinvaziri
+ * @ Description: CPU topology
+ */
+
+#ifdef __linux__
+# include <pthread.h>
+# include <sched.h>
+#endif
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <tuple>
+
+#include "Topology.hpp"
+
+namespace Flow
+{
+    /** @brief Read the first unsigned number of a sysfs file, cpu lists like '0-3,8-11' give their lowest CPU */
+    [[nodiscard]] static bool ReadFirstNumber(const std::string &path, std::uint32_t &value)
+    {
+        std::ifstream file(path);
+        return static_cast<bool>(file >> value);
+    }
+}
+
+Flow::CpuTopology::CpuTopology(std::vector<CpuInfo> &&cpus)
+    : _cpus(std::move(cpus))
+{
+    // Rank each CPU among the SMT siblings of its core so that physical cores are filled before their siblings
+    std::vector<std::uint32_t> ranks(_cpus.size(), 0u);
+    for (auto i = 0ul; i < _cpus.size(); ++i) {
+        for (auto j = 0ul; j < _cpus.size(); ++j)
+            ranks[i] += _cpus[j].core == _cpus[i].core && _cpus[j].id < _cpus[i].id;
+    }
+    std::vector<std::size_t> order(_cpus.size());
+    for (auto i = 0ul; i < order.size(); ++i)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [this, &ranks](const auto lhs, const auto rhs) {
+        const auto &l = _cpus[lhs];
+        const auto &r = _cpus[rhs];
+        return std::tie(l.package, l.cache, ranks[lhs], l.core, l.id) < std::tie(r.package, r.cache, ranks[rhs], r.core, r.id);
+    });
+    std::vector<CpuInfo> sorted;
+    sorted.reserve(_cpus.size());
+    for (const auto index : order)
+        sorted.push_back(_cpus[index]);
+    _cpus = std::move(sorted);
+}
+
+Flow::CpuTopology Flow::CpuTopology::Detect(void)
+{
+    std::vector<CpuInfo> cpus;
+
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (!::sched_getaffinity(0, sizeof(set), &set)) {
+        for (std::uint32_t id = 0u; id < CPU_SETSIZE; ++id) {
+            if (!CPU_ISSET(id, &set))
+                continue;
+            const auto path = "/sys/devices/system/cpu/cpu" + std::to_string(id);
+            CpuInfo cpu { id, id, id, 0u };
+            if (!ReadFirstNumber(path + "/topology/thread_siblings_list", cpu.core))
+                cpu.core = id;
+            if (!ReadFirstNumber(path + "/topology/physical_package_id", cpu.package))
+                cpu.package = 0u;
+            // The last level cache is the cache index of highest level, a core without cache information shares nothing
+            cpu.cache = cpu.core;
+            for (std::uint32_t index = 0u, maxLevel = 0u;; ++index) {
+                const auto cachePath = path + "/cache/index" + std::to_string(index);
+                std::uint32_t level, shared;
+                if (!ReadFirstNumber(cachePath + "/level", level))
+                    break;
+                if (level > maxLevel && ReadFirstNumber(cachePath + "/shared_cpu_list", shared)) {
+                    maxLevel = level;
+                    cpu.cache = shared;
+                }
+            }
+            cpus.push_back(cpu);
+        }
+    }
+#endif
+
+    if (cpus.empty()) {
+        const auto count = std::max(std::thread::hardware_concurrency(), 1u);
+        for (std::uint32_t id = 0u; id < count; ++id)
+            cpus.push_back(CpuInfo { id, id, id, id });
+    }
+    return CpuTopology(std::move(cpus));
+}
+
+const Flow::CpuInfo *Flow::CpuTopology::find(const std::uint32_t id) const noexcept
+{
+    for (const auto &cpu : _cpus) {
+        if (cpu.id == id)
+            return &cpu;
+    }
+    return nullptr;
+}
+
+Flow::CpuTopology Flow::CpuTopology::exclude(const std::vector<std::uint32_t> &ids) const
+{
+    CpuTopology topology;
+
+    topology._cpus.reserve(_cpus.size());
+    for (const auto &cpu : _cpus) {
+        if (std::find(ids.begin(), ids.end(), cpu.id) == ids.end())
+            topology._cpus.push_back(cpu);
+    }
+    return topology;
+}
+
+Flow::CpuDistance Flow::CpuTopology::Distance(const CpuInfo &lhs, const CpuInfo &rhs) noexcept
+{
+    if (lhs.core == rhs.core)
+        return CpuDistance::Sibling;
+    else if (lhs.cache == rhs.cache)
+        return CpuDistance::SharedCache;
+    else if (lhs.package == rhs.package)
+        return CpuDistance::Package;
+    else
+        return CpuDistance::Remote;
+}
+
+bool Flow::CpuTopology::PinThread(const std::thread::native_handle_type thread, const std::vector<std::uint32_t> &cpus) noexcept
+{
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (const auto cpu : cpus) {
+        if (cpu >= CPU_SETSIZE)
+            return false;
+        CPU_SET(cpu, &set);
+    }
+    return !cpus.empty() && !::pthread_setaffinity_np(thread, sizeof(set), &set);
+#else
+    static_cast<void>(thread);
+    static_cast<void>(cpus);
+    return false;
+#endif
+}
+
+bool Flow::CpuTopology::PinCurrentThread(const std::vector<std::uint32_t> &cpus) noexcept
+{
+#ifdef __linux__
+    return PinThread(::pthread_self(), cpus);
+#else
+    static_cast<void>(cpus);
+    return false;
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+/**
+ * @ Author: Matthieu Moinvaziri
+ * @ Description: CPU topology
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace Flow
+{
+    /** @brief Distance between two CPUs, ordered from the closest to the farthest */
+    enum class CpuDistance : std::uint8_t {
+        Sibling = 0u,   // SMT siblings of the same physical core
+        SharedCache,    // Different cores sharing their last level cache
+        Package,        // Same package but different last level caches
+        Remote          // Different packages
+    };
+
+    /** @brief Number of CPU distances */
+    constexpr std::size_t CpuDistanceCount { static_cast<std::size_t>(CpuDistance::Remote) + 1ul };
+
+    struct CpuInfo;
+    class CpuTopology;
+}
+
+/** @brief Location of a logical CPU, each domain is identified by its lowest logical CPU */
+struct Flow::CpuInfo
+{
+    std::uint32_t id { 0u }; // Logical CPU index
+    std::uint32_t core { 0u }; // Physical core, shared by SMT siblings
+    std::uint32_t cache { 0u }; // Last level cache domain
+    std::uint32_t package { 0u }; // Physical package (socket)
+};
+
+/** @brief List of the logical CPUs of a machine, sorted so that consecutive CPUs share the most caches
+ *  Within a cache domain the first hardware thread of every core comes before SMT siblings, so that a few workers spread over physical cores */
+class Flow::CpuTopology
+{
+public:
+    /** @brief Index of an unknown CPU */
+    static constexpr std::uint32_t NoCpu { ~0u };
+
+    /** @brief Construct an empty topology */
+    CpuTopology(void) noexcept = default;
+
+    /** @brief Construct a topology from a list of CPUs */
+    explicit CpuTopology(std::vector<CpuInfo> &&cpus);
+
+    /** @brief Detect the topology of the CPUs the process may run on
+     *  On Linux it is read from sysfs, other platforms (or a missing sysfs) give hardware threads without any shared domain */
+    [[nodiscard]] static CpuTopology Detect(void);
+
+    /** @brief Get the list of CPUs */
+    [[nodiscard]] const std::vector<CpuInfo> &cpus(void) const noexcept { return _cpus; }
+
+    /** @brief Get the number of CPUs */
+    [[nodiscard]] std::size_t size(void) const noexcept { return _cpus.size(); }
+
+    /** @brief Check if the topology is empty */
+    [[nodiscard]] bool empty(void) const noexcept { return _cpus.empty(); }
+
+    /** @brief Find a CPU by its logical index, null if it doesn't belong to the topology */
+    [[nodiscard]] const CpuInfo *find(const std::uint32_t id) const noexcept;
+
+    /** @brief Get a copy of the topology without a set of CPUs */
+    [[nodiscard]] CpuTopology exclude(const std::vector<std::uint32_t> &ids) const;
+
+    /** @brief Get the distance between two CPUs */
+    [[nodiscard]] static CpuDistance Distance(const CpuInfo &lhs, const CpuInfo &rhs) noexcept;
+
+    /** @brief Restrict a thread to a set of CPUs, returns false on failure or if unsupported (Linux only) */
+    static bool PinThread(const std::thread::native_handle_type thread, const std::vector<std::uint32_t> &cpus) noexcept;
+
+    /** @brief Restrict the calling thread to a set of CPUs, i.e. an audio I/O thread running on cores excluded from the scheduler */
+    static bool PinCurrentThread(const std::vector<std::uint32_t> &cpus) noexcept;
+
+private:
+    std::vector<CpuInfo> _cpus {};
+};
@@ -0,0 +1,84 @@
+/**
+ * @ Author: Matthieu Moinvaziri
+ * @ Description: Node execution tracing
+ */
+
+#include <iomanip>
+
+#include "Trace.hpp"
+
+namespace Flow
+{
+    /** @brief Get the display name of a node type */
+    [[nodiscard]] static const char *NodeTypeName(const NodeType type) noexcept
+    {
+        switch (type) {
+        case NodeType::Static:
+            return "Static";
+        case NodeType::Dynamic:
+            return "Dynamic";
+        case NodeType::Switch:
+            return "Switch";
+        case NodeType::Graph:
+            return "Graph";
+        case NodeType::Coroutine:
+            return "Coroutine";
+        default:
+            return "None";
+        }
+    }
+
+    /** @brief Write a JSON escaped string */
+    static void WriteJsonString(std::ostream &stream, const char *string)
+    {
+        stream << '"';
+        for (; *string; ++string) {
+            const auto c = static_cast<unsigned char>(*string);
+            if (c == '"' || c == '\\')
+                stream << '\\' << *string;
+            else if (c < 0x20u)
+                stream << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<unsigned>(c) << std::dec << std::setfill(' ');
+            else
+                stream << *string;
+        }
+        stream << '"';
+    }
+
+    /** @brief Write a nanosecond timestamp as microseconds */
+    static void WriteMicroseconds(std::ostream &stream, const std::int64_t nanoseconds)
+    {
+        stream << nanoseconds / 1000 << '.' << std::setw(3) << std::setfill('0') << nanoseconds % 1000 << std::setfill(' ');
+    }
+}
+
+Flow::TraceBuffer::TraceBuffer(const std::size_t capacity)
+    : _mask(capacity - 1ul)
+{
+    if (!capacity || (capacity & (capacity - 1ul)))
+        throw std::logic_error("Flow::TraceBuffer: Capacity must be a power of 2");
+    _events.allocate(capacity);
+}
+
+void Flow::TraceBuffer::ExportChromeTrace(std::ostream &stream, const TraceBuffer * const begin, const TraceBuffer * const end)
+{
+    bool first = true;
+
+    stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    for (auto buffer = begin; buffer != end; ++buffer) {
+        buffer->forEach([&stream, &first](const TraceEvent &event) {
+            if (!first)
+                stream << ',';
+            first = false;
+            stream << "\n{\"name\":";
+            WriteJsonString(stream, *event.name ? event.name : NodeTypeName(event.type));
+            stream << ",\"cat\":\"" << NodeTypeName(event.type) << "\",\"ph\":\"X\",\"ts\":";
+            WriteMicroseconds(stream, event.begin);
+            stream << ",\"dur\":";
+            WriteMicroseconds(stream, event.end - event.begin);
+            stream << ",\"pid\":0,\"tid\":" << event.worker
+                << ",\"args\":{\"iteration\":" << event.iteration
+                << ",\"origin\":\"" << (event.stolen ? "steal" : "local") << "\"}}";
+        });
+    }
+    stream << "\n]}\n";
+}
@@ -0,0 +1,100 @@
+/**
+ * @ Author: Matthieu Moinvaziri
+ * @ Description: Node execution tracing
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+
+#include <Core/HeapArray.hpp>
+
+#include "NodeType.hpp"
+
+namespace Flow
+{
+    /** @brief Tracing is compiled out when FLOW_DISABLE_TRACING is defined */
+#ifdef FLOW_DISABLE_TRACING
+    constexpr bool TracingEnabled = false;
+#else
+    constexpr bool TracingEnabled = true;
+#endif
+
+    /** @brief Clock of trace timestamps */
+    using TraceClock = std::chrono::steady_clock;
+
+    struct TraceEvent;
+    class TraceBuffer;
+}
+
+/** @brief Execution record of a single node */
+struct alignas_cacheline Flow::TraceEvent
+{
+    /** @brief Maximum name length kept by an event, longer names are truncated */
+    static constexpr std::size_t MaxNameLength { 31ul };
+
+    std::int64_t begin { 0 }; // Begin timestamp in nanoseconds since TraceClock epoch
+    std::int64_t end { 0 }; // End timestamp in nanoseconds since TraceClock epoch
+    NodeType type { NodeType::Static }; // Work type of the node
+    std::uint32_t iteration { 0u }; // Run index of the node's graph
+    std::uint16_t worker { 0u }; // Index of the executing worker
+    bool stolen { false }; // True if the task was stolen from another worker
+    char name[MaxNameLength + 1ul] {}; // Null terminated node name, copied so the event outlives its graph
+
+    /** @brief Copy a node name into the event */
+    void setName(const std::string_view &nodeName) noexcept;
+};
+
+static_assert_fit_cacheline(Flow::TraceEvent);
+
+/**
+ * @brief Fixed capacity ring buffer of trace events
+ *  The owner worker is the only writer, once full the oldest events are overwritten
+ *  Reading is only consistent while no traced graph is running
+ */
+class alignas_cacheline Flow::TraceBuffer
+{
+public:
+    /** @brief Default event capacity of a buffer (must be a power of 2) */
+    static constexpr std::size_t DefaultCapacity { 4096ul };
+
+    /** @brief Construct the buffer with a power of 2 capacity */
+    TraceBuffer(const std::size_t capacity = DefaultCapacity);
+
+    /** @brief Trace buffers can't be copied nor moved */
+    TraceBuffer(const TraceBuffer &other) = delete;
+    TraceBuffer &operator=(const TraceBuffer &other) = delete;
+
+    /** @brief Record an event, overwriting the oldest one if the buffer is full (only the owner worker may call this) */
+    void record(const TraceEvent &event) noexcept;
+
+    /** @brief Get the number of stored events */
+    [[nodiscard]] std::size_t size(void) const noexcept;
+
+    /** @brief Get the event capacity */
+    [[nodiscard]] std::size_t capacity(void) const noexcept { return _events.size(); }
+
+    /** @brief Get the total number of recorded events, including overwritten ones */
+    [[nodiscard]] std::uint64_t recordCount(void) const noexcept { return _head.load(std::memory_order_acquire); }
+
+    /** @brief Call 'callback' on each stored event, from the oldest to the newest */
+    template<typename Callback>
+    void forEach(Callback &&callback) const;
+
+    /** @brief Remove every event (racy if the owner worker is recording) */
+    void clear(void) noexcept { _head.store(0u, std::memory_order_release); }
+
+    /** @brief Export a set of buffers as Chrome trace JSON, readable by chrome://tracing and Perfetto */
+    static void ExportChromeTrace(std::ostream &stream, const TraceBuffer * const begin, const TraceBuffer * const end);
+
+private:
+    Core::HeapArray<TraceEvent> _events {};
+    std::size_t _mask { 0ul };
+    alignas_cacheline std::atomic<std::uint64_t> _head { 0u };
+};
+
+#include "Trace.ipp"
@@ -0,0 +1,37 @@
+/**
+ * @ Author: Matthieu Moinvaziri
+ * @ Description: Node execution tracing
+ */
+
+inline void Flow::TraceEvent::setName(const std::string_view &nodeName) noexcept
+{
+    const auto length = nodeName.size() < MaxNameLength ? nodeName.size() : MaxNameLength;
+
+    nodeName.copy(name, length);
+    name[length] = '\0';
+}
+
+inline void Flow::TraceBuffer::record(const TraceEvent &event) noexcept
+{
+    const auto head = _head.load(std::memory_order_relaxed);
+
+    _events[static_cast<std::size_t>(head) & _mask] = event;
+    _head.store(head + 1u, std::memory_order_release);
+}
+
+inline std::size_t Flow::TraceBuffer::size(void) const noexcept
+{
+    const auto head = _head.load(std::memory_order_acquire);
+
+    return head < capacity() ? static_cast<std::size_t>(head) : capacity();
+}
+
+template<typename Callback>
+inline void Flow::TraceBuffer::forEach(Callback &&callback) const
+{
+    const auto head = _head.load(std::memory_order_acquire);
+    const auto count = size();
+
+    for (auto i = head - count; i != head; ++i)
+        callback(_events[static_cast<std::size_t>(i) & _mask]);
+}
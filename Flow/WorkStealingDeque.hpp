@@ -0,0 +1,106 @@
+/**
+ * @ Author: Matthieu Moinvaziri
+ * @ Description: Work stealing deque
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include <Core/Assert.hpp>
+#include <Core/Vector.hpp>
+
+namespace Flow
+{
+    template<typename Type>
+    class WorkStealingDeque;
+}
+
+/**
+ * @brief Growable lock-free Chase-Lev deque
+ *  The owner thread pushes and pops at the bottom (LIFO) without any CAS unless it races for the last element
+ *  Any other thread may steal from the top (FIFO)
+ *  Retired buffers are kept until destruction so that concurrent thieves never read freed memory
+ */
+template<typename Type>
+class alignas_double_cacheline Flow::WorkStealingDeque
+{
+public:
+    static_assert(std::is_trivially_copyable_v<Type>, "Flow::WorkStealingDeque: Type must be trivially copyable");
+
+    /** @brief Default initial capacity of the deque (must be a power of 2) */
+    static constexpr std::int64_t DefaultCapacity { 1024 };
+
+    /** @brief Construct the deque with an initial power of 2 capacity */
+    WorkStealingDeque(const std::int64_t capacity = DefaultCapacity);
+
+    /** @brief Destroy the deque and all its buffers */
+    ~WorkStealingDeque(void) noexcept;
+
+    /** @brief Push an element at the bottom of the deque (only the owner thread may call this) */
+    void push(const Type value);
+
+    /** @brief Push a range of elements at the bottom of the deque, growing and publishing once (only the owner thread may call this) */
+    void push(const Type * const begin, const Type * const end);
+
+    /** @brief Pop an element from the bottom of the deque (only the owner thread may call this) */
+    [[nodiscard]] bool pop(Type &value) noexcept;
+
+    /** @brief Steal an element from the top of the deque (any thread may call this) */
+    [[nodiscard]] bool steal(Type &value) noexcept;
+
+    /** @brief Get an approximation of the number of elements in the deque */
+    [[nodiscard]] std::size_t size(void) const noexcept;
+
+    /** @brief Fast check if the deque looks empty */
+    [[nodiscard]] bool empty(void) const noexcept { return !size(); }
+
+    /** @brief Get the current capacity of the deque */
+    [[nodiscard]] std::int64_t capacity(void) const noexcept { return _cache.buffer.load(std::memory_order_relaxed)->capacity(); }
+
+private:
+    /** @brief Circular buffer of atomic elements */
+    class Buffer
+    {
+    public:
+        /** @brief Allocate a buffer of a given power of 2 capacity */
+        Buffer(const std::int64_t capacity) : _mask(capacity - 1), _data(new std::atomic<Type>[static_cast<std::size_t>(capacity)]) {}
+
+        /** @brief Release the buffer */
+        ~Buffer(void) noexcept { delete[] _data; }
+
+        /** @brief Get buffer capacity */
+        [[nodiscard]] std::int64_t capacity(void) const noexcept { return _mask + 1; }
+
+        /** @brief Store an element at a given unbounded index */
+        void store(const std::int64_t index, const Type value) noexcept
+            { _data[index & _mask].store(value, std::memory_order_relaxed); }
+
+        /** @brief Load an element at a given unbounded index */
+        [[nodiscard]] Type load(const std::int64_t index) const noexcept
+            { return _data[index & _mask].load(std::memory_order_relaxed); }
+
+        /** @brief Create a buffer twice larger containing the range [top, bottom[ */
+        [[nodiscard]] Buffer *grow(const std::int64_t top, const std::int64_t bottom) const;
+
+    private:
+        std::int64_t _mask;
+        std::atomic<Type> *_data;
+    };
+
+    struct Cache
+    {
+        std::atomic<Buffer *> buffer { nullptr };
+        Core::TinyVector<Buffer *> garbage {};
+    };
+
+    // Cacheline 1, thieves side
+    alignas_cacheline std::atomic<std::int64_t> _top { 0 };
+
+    // Cacheline 2, owner side
+    alignas_cacheline std::atomic<std::int64_t> _bottom { 0 };
+    Cache _cache {};
+};
+
+#include "WorkStealingDeque.ipp"
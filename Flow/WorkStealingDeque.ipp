@@ -0,0 +1,117 @@
+/**
+ * @ Author: Matthieu Moinvaziri
+ * @ Description: Work stealing deque
+ */
+
+template<typename Type>
+inline Flow::WorkStealingDeque<Type>::WorkStealingDeque(const std::int64_t capacity)
+{
+    coreAssert(capacity > 0 && (capacity & (capacity - 1)) == 0,
+        throw std::logic_error("Flow::WorkStealingDeque: Capacity must be a power of 2"));
+    _cache.buffer.store(new Buffer(capacity), std::memory_order_relaxed);
+}
+
+template<typename Type>
+inline Flow::WorkStealingDeque<Type>::~WorkStealingDeque(void) noexcept
+{
+    delete _cache.buffer.load(std::memory_order_relaxed);
+    for (const auto buffer : _cache.garbage)
+        delete buffer;
+}
+
+template<typename Type>
+inline void Flow::WorkStealingDeque<Type>::push(const Type value)
+{
+    const auto bottom = _bottom.load(std::memory_order_relaxed);
+    const auto top = _top.load(std::memory_order_acquire);
+    auto buffer = _cache.buffer.load(std::memory_order_relaxed);
+
+    if (bottom - top > buffer->capacity() - 1) [[unlikely]] {
+        _cache.garbage.push(buffer);
+        buffer = buffer->grow(top, bottom);
+        _cache.buffer.store(buffer, std::memory_order_release);
+    }
+    buffer->store(bottom, value);
+    _bottom.store(bottom + 1, std::memory_order_release);
+}
+
+template<typename Type>
+inline void Flow::WorkStealingDeque<Type>::push(const Type * const begin, const Type * const end)
+{
+    const auto count = static_cast<std::int64_t>(end - begin);
+    const auto bottom = _bottom.load(std::memory_order_relaxed);
+    const auto top = _top.load(std::memory_order_acquire);
+    auto buffer = _cache.buffer.load(std::memory_order_relaxed);
+
+    if (bottom - top + count > buffer->capacity()) [[unlikely]] {
+        do {
+            _cache.garbage.push(buffer);
+            buffer = buffer->grow(top, bottom);
+        } while (bottom - top + count > buffer->capacity());
+        _cache.buffer.store(buffer, std::memory_order_release);
+    }
+    for (auto i = 0; i < count; ++i)
+        buffer->store(bottom + i, begin[i]);
+    _bottom.store(bottom + count, std::memory_order_release);
+}
+
+template<typename Type>
+inline bool Flow::WorkStealingDeque<Type>::pop(Type &value) noexcept
+{
+    const auto bottom = _bottom.load(std::memory_order_relaxed) - 1;
+    const auto buffer = _cache.buffer.load(std::memory_order_relaxed);
+
+    _bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto top = _top.load(std::memory_order_relaxed);
+    if (top > bottom) {
+        _bottom.store(bottom + 1, std::memory_order_relaxed);
+        return false;
+    }
+    const auto tmp = buffer->load(bottom);
+    if (top == bottom) {
+        // Last element, race against thieves
+        const bool won = _top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        _bottom.store(bottom + 1, std::memory_order_relaxed);
+        if (!won)
+            return false;
+    }
+    value = tmp;
+    return true;
+}
+
+template<typename Type>
+inline bool Flow::WorkStealingDeque<Type>::steal(Type &value) noexcept
+{
+    auto top = _top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const auto bottom = _bottom.load(std::memory_order_acquire);
+
+    if (top >= bottom)
+        return false;
+    const auto buffer = _cache.buffer.load(std::memory_order_acquire);
+    const auto tmp = buffer->load(top);
+    if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        return false;
+    value = tmp;
+    return true;
+}
+
+template<typename Type>
+inline std::size_t Flow::WorkStealingDeque<Type>::size(void) const noexcept
+{
+    const auto bottom = _bottom.load(std::memory_order_relaxed);
+    const auto top = _top.load(std::memory_order_relaxed);
+
+    return bottom > top ? static_cast<std::size_t>(bottom - top) : 0ul;
+}
+
+template<typename Type>
+inline typename Flow::WorkStealingDeque<Type>::Buffer *Flow::WorkStealingDeque<Type>::Buffer::grow(const std::int64_t top, const std::int64_t bottom) const
+{
+    auto buffer = new Buffer(capacity() * 2);
+
+    for (auto i = top; i != bottom; ++i)
+        buffer->store(i, load(i));
+    return buffer;
+}
@@ -3,69 +3,233 @@
  * @ Description: Worker thread
  */
 
-#include <iostream>
-
 #include "Scheduler.hpp"
 
-Flow::Worker::Worker(Scheduler * const parent, const std::size_t queueSize)
+Flow::Worker::Worker(Scheduler * const parent)
     : _cache(Cache {
         parent,
-        std::thread()
-    }),
-    _queue(queueSize)
+        std::thread(),
+        reinterpret_cast<std::uintptr_t>(this) | 1u
+    })
+{
+}
+
+namespace Flow
 {
+    /** @brief Get a timestamp in nanoseconds for the runtime counters */
+    [[nodiscard]] static std::int64_t CounterTimestamp(void) noexcept
+        { return std::chrono::nanoseconds(std::chrono::steady_clock::now().time_since_epoch()).count(); }
 }
 
 void Flow::Worker::run(void)
 {
+    _Current = this;
+    _counters.activeSince.store(CounterTimestamp(), std::memory_order_relaxed);
     while (state() == State::Running) {
-        if (Task task; _queue.pop(task) || _cache.parent->steal(task))
+        if (Task task; pop(task))
             work(task);
+        else if (bool stolen; search(task, stolen))
+            work(task, stolen);
+        else if (_cache.parent->hasDeadlineGraphs())
+            CpuPause(); // Stay hot while a deadline graph is in flight
         else {
             auto s = State::Running;
             if (!_state.compare_exchange_weak(s, State::IDLE))
                 continue;
-            atomic_sync::atomic_wait_explicit(&_state, State::IDLE, std::memory_order_relaxed);
+            _cache.parent->workerParked();
+            // Check again after publishing the IDLE state so a concurrent submission or the last searcher stopping can't be missed
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (taskCount() || _cache.parent->lacksSearchingWorker()) {
+                s = State::IDLE;
+                _state.compare_exchange_strong(s, State::Running);
+            } else {
+                const auto parkTime = CounterTimestamp();
+                WorkerCounters::Increment(_counters.runningNanoseconds, parkTime - _counters.activeSince.load(std::memory_order_relaxed));
+                _counters.activeSince.store(0, std::memory_order_relaxed);
+                atomic_sync::atomic_wait_explicit(&_state, State::IDLE, std::memory_order_relaxed);
+                const auto wakeUpTime = CounterTimestamp();
+                WorkerCounters::Increment(_counters.parkedNanoseconds, wakeUpTime - parkTime);
+                WorkerCounters::Increment(_counters.wakeUpsReceived);
+                _counters.activeSince.store(wakeUpTime, std::memory_order_relaxed);
+            }
+            _cache.parent->workerUnparked();
         }
     }
+    WorkerCounters::Increment(_counters.runningNanoseconds, CounterTimestamp() - _counters.activeSince.load(std::memory_order_relaxed));
+    _counters.activeSince.store(0, std::memory_order_relaxed);
     _state = State::Stopped;
 }
 
-void Flow::Worker::work(Task &task)
+Flow::WorkerStats Flow::Worker::stats(void) const noexcept
 {
-    try {
-        std::uint32_t joinCount;
-        switch (task.type()) {
-        case NodeType::Static:
-            joinCount = dispatchStaticNode(task.node());
-            break;
-        case NodeType::Dynamic:
-            joinCount = dispatchDynamicNode(task.node());
-            break;
-        case NodeType::Switch:
-            joinCount = dispatchSwitchNode(task.node());
-            break;
-        case NodeType::Graph:
-            joinCount = dispatchGraphNode(task.node());
-            break;
-        default:
-            throw std::logic_error("Flow::Worker::Work: Undefined node");
+    WorkerStats stats;
+    const auto activeSince = _counters.activeSince.load(std::memory_order_relaxed);
+    auto running = _counters.runningNanoseconds.load(std::memory_order_relaxed);
+
+    if (activeSince)
+        running += CounterTimestamp() - activeSince;
+    stats.tasksExecuted = _counters.tasksExecuted.load(std::memory_order_relaxed);
+    stats.localPops = _counters.localPops.load(std::memory_order_relaxed);
+    stats.steals = _counters.steals.load(std::memory_order_relaxed);
+    stats.failedSteals = _counters.failedSteals.load(std::memory_order_relaxed);
+    stats.wakeUpsIssued = _counters.wakeUpsIssued.load(std::memory_order_relaxed);
+    stats.wakeUpsReceived = _counters.wakeUpsReceived.load(std::memory_order_relaxed);
+    stats.inboxRetries = _inboxRetries.load(std::memory_order_relaxed);
+    stats.notificationsCoalesced = _counters.notificationsCoalesced.load(std::memory_order_relaxed);
+    stats.notificationsDropped = _counters.notificationsDropped.load(std::memory_order_relaxed);
+    stats.parkedTime = std::chrono::nanoseconds(_counters.parkedNanoseconds.load(std::memory_order_relaxed));
+    stats.runningTime = std::chrono::nanoseconds(running);
+    return stats;
+}
+
+bool Flow::Worker::search(Task &task, bool &stolen) noexcept
+{
+    const auto &policy = _cache.parent->stealPolicy();
+    const auto passCount = policy.attempts + policy.yields;
+    const auto acquire = [this, &task, &stolen] {
+        if (stealFromOthers(task))
+            stolen = true;
+        else if (pop(task))
+            stolen = false;
+        else
+            return false;
+        return true;
+    };
+    Backoff backoff(policy.backoffMinSpins, policy.backoffMaxSpins);
+
+    _cache.parent->workerStartedSearching();
+    for (auto i = 0u; state() == State::Running; ++i) {
+        if (acquire()) {
+            // The last searcher hands the search over to a parked worker as more work may be pending
+            if (_cache.parent->workerStoppedSearching())
+                _cache.parent->wakeUpIdleWorker();
+            return true;
+        } else if (i < policy.attempts)
+            backoff.pause();
+        else if (bool last = false; i < passCount || !_cache.parent->workerTryStopSearching(last))
+            std::this_thread::yield();
+        else if (!last)
+            return false;
+        else {
+            // Submitters skipped their wake-up while this worker was searching, so the last searcher must look once more before parking
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (acquire()) {
+                _cache.parent->wakeUpIdleWorker();
+                return true;
+            }
+            // A worker parked after the stop decision, it must not be left without a searcher
+            if (!policy.keepSearching || !_cache.parent->idleWorkerCount())
+                return false;
+            _cache.parent->workerStartedSearching();
+        }
+    }
+    static_cast<void>(_cache.parent->workerStoppedSearching());
+    return false;
+}
+
+void Flow::Worker::work(Task &task, const bool stolen)
+{
+    std::uint32_t fusedJoins { 0u }; // Joins of fused nodes, deferred to the end of their chain
+
+    for (auto origin = stolen; task; origin = false) {
+        Task next;
+        const auto node = task.node();
+        const auto root = node->root;
+        if (root->cancelled()) [[unlikely]] {
+            // Nodes of a cancelled or failed run are joined without executing their work
+            root->childrenJoined(std::exchange(fusedJoins, 0u) + drainNode(node, next));
+            task = next;
+            continue;
         }
-        if (!task.hasNotification()) {
-            task.node()->root->childrenJoined(joinCount);
-            return;
+        // A node starting after the deadline applies the policy even if no late node completed yet
+        if (root->hasDeadline())
+            _cache.parent->checkDeadline(node);
+        WorkerCounters::Increment(_counters.tasksExecuted);
+        const auto compiled = root->compiled();
+        // Static schedules are planned from the measured cost of each node
+        const bool traced = TracingEnabled && _cache.trace;
+        const bool timed = (compiled && compiled->staticSchedule) || traced;
+        const auto start = timed ? DeadlineClock::now() : Deadline();
+        std::uint32_t joinCount;
+        _cache.dispatchStart = start;
+        _cache.dispatchStolen = origin;
+        try {
+            joinCount = dispatchNode(node, compiled, next);
+        } catch (...) {
+            // The first exception fails the run, the thrown node and its successors are drained
+            root->fail(std::current_exception());
+            next = Task();
+            root->childrenJoined(std::exchange(fusedJoins, 0u) + drainNode(node, next));
+            task = next;
+            continue;
         }
-        // If the task has notification, loop until parent scheduler accept it
-        while (!_cache.parent->notify(task) && state() == State::Running) {
-            if (Task task; _queue.pop(task) || _cache.parent->steal(task))
-                work(task);
-            else
-                std::this_thread::yield();
+        if (!joinCount) {
+            // Suspended on a nested graph or a coroutine: the node and its graph must not be accessed anymore as they may already be completed
+            task = next;
+            continue;
         }
-        task.node()->root->childrenJoined(joinCount);
-    } catch (const std::exception &e) {
-        std::cout << "Flow::Worker::work: Exception thrown in task '" << task.name() << "': " << e.what() << std::endl;
-    } catch (...) {
-        std::cout << "Flow::Worker::work: Unknown exception thrown in task '" << task.name() << '\'' << std::endl;
+        if (compiled && compiled->staticSchedule)
+            compiled->recordCost(node->index, static_cast<std::uint64_t>(std::chrono::nanoseconds(DeadlineClock::now() - start).count()));
+        if (traced) [[unlikely]]
+            trace(task, start, origin);
+        if (root->hasDeadline())
+            _cache.parent->checkDeadline(node);
+        notifyNode(task);
+        if (IsFused(node, compiled))
+            fusedJoins += joinCount;
+        else
+            root->childrenJoined(std::exchange(fusedJoins, 0u) + joinCount);
+        task = next;
+    }
+}
+
+void Flow::Worker::notifyNode(Task task)
+{
+    if (!task.hasNotification())
+        return;
+    switch (_cache.notifications->push(task.node(), _cache.parent->notificationPolicy())) {
+    case NotificationQueue::PushResult::Coalesced:
+        WorkerCounters::Increment(_counters.notificationsCoalesced);
+        return;
+    case NotificationQueue::PushResult::DroppedOldest:
+        WorkerCounters::Increment(_counters.notificationsDropped);
+        break;
+    default:
+        break;
     }
+    _cache.parent->notificationQueued();
+}
+
+std::uint32_t Flow::Worker::dispatchNode(Node * const node, CompiledGraph * const compiled, Task &next)
+{
+    if (compiled && node->index < compiled->staticCount())
+        return dispatchCompiledStaticNode(*compiled, node, next);
+    switch (static_cast<NodeType>(node->workData.index())) {
+    case NodeType::Static:
+        return dispatchStaticNode(node, next);
+    case NodeType::Dynamic:
+        return dispatchDynamicNode(node, next);
+    case NodeType::Switch:
+        return dispatchSwitchNode(node, next);
+    case NodeType::Graph:
+        return dispatchGraphNode(node, next);
+    case NodeType::Coroutine:
+        return dispatchCoroutineNode(node, next);
+    default:
+        throw std::logic_error("Flow::Worker::Work: Undefined node");
+    }
+}
+
+void Flow::Worker::trace(const Task task, const TraceClock::time_point begin, const bool stolen) noexcept
+{
+    TraceEvent event;
+
+    event.begin = std::chrono::nanoseconds(begin.time_since_epoch()).count();
+    event.end = std::chrono::nanoseconds(TraceClock::now().time_since_epoch()).count();
+    event.type = task.type();
+    event.iteration = task.node()->root->runState() >> 1;
+    event.worker = static_cast<std::uint16_t>(_cache.parent->workerIndex(*this));
+    event.stolen = stolen;
+    event.setName(task.name());
+    _cache.trace->record(event);
 }
@@ -7,10 +7,13 @@
 
 // This header must no be directly included, include 'Scheduler' instead
 
-#include <Core/MPMCQueue.hpp>
-
 #include "AtomicWait.hpp"
+#include "Backoff.hpp"
+#include "Stats.hpp"
+#include "Trace.hpp"
+#include "WorkStealingDeque.hpp"
 #include "Graph.hpp"
+#include "NotificationQueue.hpp"
 
 namespace Flow
 {
@@ -34,13 +37,13 @@ public:
     };
 
     /** @brief Construct and start the worker */
-    Worker(Scheduler * const parent, const std::size_t queueSize);
+    Worker(Scheduler * const parent);
 
     /** @brief Destroy the worker without stopping it ! */
     ~Worker(void) = default;
 
-    /** @brief Start the worker */
-    void start(void);
+    /** @brief Start the worker, its thread is restricted to 'cpus' (if any) before running anything */
+    void start(const std::size_t index, std::vector<std::uint32_t> &&cpus);
 
     /** @brief Stop the worker */
     void stop(void) noexcept;
@@ -48,57 +51,170 @@ public:
     /** @brief Join the worker */
     void join(void) noexcept;
 
+    /** @brief Get the worker running on the calling thread, null outside of workers */
+    [[nodiscard]] static Worker *Current(void) noexcept { return _Current; }
+
+    /** @brief Get the native handle of the worker thread (the worker must be started) */
+    [[nodiscard]] std::thread::native_handle_type nativeHandle(void) noexcept { return _cache.thd.native_handle(); }
+
+    /** @brief Get the scheduler owning the worker */
+    [[nodiscard]] Scheduler *parent(void) const noexcept { return _cache.parent; }
+
+    /** @brief Set the trace buffer recording executed nodes, null disables tracing (setting it while the worker is working is racy) */
+    void setTraceBuffer(TraceBuffer * const buffer) noexcept { _cache.trace = buffer; }
+
+    /** @brief Set the queue receiving the notifications of executed nodes (must be set before the worker starts) */
+    void setNotificationQueue(NotificationQueue * const queue) noexcept { _cache.notifications = queue; }
+
+    /** @brief Get a snapshot of the worker's runtime counters (any thread may call this) */
+    [[nodiscard]] WorkerStats stats(void) const noexcept;
+
     /** @brief Get internal state of worker */
     [[nodiscard]] State state(void) noexcept { return _state.load(std::memory_order_relaxed); }
 
-    /** @brief Push a task to be processed on the worker thread */
-    [[nodiscard]] bool push(const Task task) noexcept { return _queue.push(task); }
+    /** @brief Push a task into the queue of its priority, to be processed on the worker thread (only the worker thread may call this) */
+    void push(const Task task) noexcept { _queues[QueueIndex(task)].push(task); }
+
+    /** @brief Submit a task to be processed on the worker thread (any thread may call this) */
+    void submit(const Task task) noexcept;
+
+    /** @brief Submit a range of tasks to be processed on the worker thread, locking the inbox once (any thread may call this) */
+    void submit(const Task * const begin, const Task * const end) noexcept;
 
-    /** @brief Try to steal a task from worker */
-    [[nodiscard]] bool steal(Task &task) noexcept { return _queue.pop(task); }
+    /** @brief Complete a node suspended on its nested graph, its successors are released and the node is joined
+     *  The node is traced and costed from its dispatch time 'start' (null if it wasn't timed)
+     *  Must be called by the worker completing the nested run
+     *  Reserved for internal use ! */
+    void resumeNode(Node * const node, const Deadline start, const bool stolen);
 
-    /** @brief Get the task count of the queue */
-    [[nodiscard]] std::size_t taskCount(void) const noexcept { return _queue.size(); }
+    /** @brief Try to steal a task from worker, highest priorities first */
+    [[nodiscard]] bool steal(Task &task) noexcept;
+
+    /** @brief Try to steal half of the tasks of the worker, the first one is returned and the others are pushed into thief's queue
+     *  Must be called from the thief's thread */
+    [[nodiscard]] bool stealHalf(Worker &thief, Task &task) noexcept;
+
+    /** @brief Get a pseudo random number (only the worker thread may call this) */
+    [[nodiscard]] std::size_t random(void) noexcept;
+
+    /** @brief Get the task count of every queue */
+    [[nodiscard]] std::size_t taskCount(void) const noexcept;
 
     /** @brief Notify that the worker should work right now */
     void wakeUp(const State state) noexcept;
 
+    /** @brief Wake up the worker only if it is IDLE, returns true on success */
+    bool tryWakeUp(void) noexcept;
+
 private:
     struct Cache
     {
         Scheduler *parent { nullptr };
         std::thread thd {};
+        std::uint64_t seed { 0u };
+        TraceBuffer *trace { nullptr };
+        NotificationQueue *notifications { nullptr };
+        Deadline dispatchStart {}; // Dispatch time of the current node, null if it isn't timed
+        bool dispatchStolen { false }; // True if the current node was stolen
     };
 
     alignas_cacheline std::atomic<State> _state { State::Stopped };
     alignas_cacheline Cache _cache {};
-    Core::MPMCQueue<Task> _queue;
+    WorkStealingDeque<Task> _queues[PriorityCount] {}; // Tasks pushed by the worker itself, one queue per priority
+    WorkStealingDeque<Task> _inboxes[PriorityCount] {}; // Tasks submitted by other threads, pushes are serialized by '_inboxLock'
+    alignas_cacheline std::atomic<bool> _inboxLock { false };
+    std::atomic<std::uint64_t> _inboxRetries { 0u }; // Shares the contended cacheline of the inbox lock
+    WorkerCounters _counters {};
+
+    inline static thread_local Worker *_Current { nullptr };
 
     /** @brief Busy loop */
     void run(void);
 
-    /** @brief Execute a task */
-    void work(Task &task);
+    /** @brief Lock / unlock the inbox for pushing */
+    void lockInbox(void) noexcept;
+    void unlockInbox(void) noexcept { _inboxLock.store(false, std::memory_order_release); }
+
+    /** @brief Get the queue index of a task */
+    [[nodiscard]] static std::size_t QueueIndex(const Task task) noexcept { return static_cast<std::size_t>(task.node()->level); }
+
+    /** @brief Pop a task from the local queue, then from the inbox, highest priorities first */
+    [[nodiscard]] bool pop(Task &task) noexcept;
+
+    /** @brief Steal a task from another worker */
+    [[nodiscard]] bool stealFromOthers(Task &task) noexcept;
+
+    /** @brief Pop a task, else steal one from another worker, 'stolen' tells where the task comes from */
+    [[nodiscard]] bool acquire(Task &task, bool &stolen) noexcept;
+
+    /** @brief Search for a task following the scheduler's steal policy: steal passes separated by spinning, then by yielding
+     *  Tasks submitted meanwhile to this worker are popped, 'stolen' tells where the task comes from
+     *  The worker is counted as searching during the call, the last searcher to find a task wakes up a parked worker to take over */
+    [[nodiscard]] bool search(Task &task, bool &stolen) noexcept;
+
+    /** @brief Execute a task, then its continuations, 'stolen' tells if the first task comes from another worker */
+    void work(Task &task, const bool stolen = false);
+
+    /** @brief Execute the work of a node, returns its join count */
+    [[nodiscard]] std::uint32_t dispatchNode(Node * const node, CompiledGraph * const compiled, Task &next);
+
+    /** @brief Join a node of a cancelled or failed run without executing its work, returns its join count
+     *  Successors are still scheduled to be drained in turn, the branches of a switch node are joined at once */
+    [[nodiscard]] std::uint32_t drainNode(Node * const node, Task &next);
+
+    /** @brief Record the execution of a node into the trace buffer */
+    void trace(const Task task, const TraceClock::time_point begin, const bool stolen) noexcept;
 
 private:
-    /** @brief Work untile given graph finished */
-    void blockingGraphSchedule(Graph &graph);
+    /** @brief Schedule the nested graph of a node and suspend the node until the nested run is completed, returns a null join count */
+    [[nodiscard]] std::uint32_t scheduleNestedGraph(Node * const node, Graph &graph);
+
+    /** @brief Queue the notification of a task into the worker's notification queue, never waiting for the event thread */
+    void notifyNode(Task task);
+
+    /** @brief Check if a node executes its successor right after itself, see Graph::setChainFusion */
+    [[nodiscard]] static bool IsFused(const Node * const node, const CompiledGraph * const compiled) noexcept;
 
-    /** @brief Tries to schedule a single node */
-    void scheduleNode(Node * const node);
+    /** @brief Check if the work of a node must be skipped (bypassed or late non-critical node) */
+    [[nodiscard]] bool isBypassed(const Node * const node) const noexcept;
+
+    /** @brief Tries to schedule a single node
+     *  If ready, the node becomes the continuation 'next' when it is not yet set, else it is pushed into the local queue */
+    void scheduleNode(Node * const node, Task &next);
+
+    /** @brief Tries to schedule a single node of a compiled graph, using its packed join counters */
+    void scheduleCompiledNode(CompiledGraph &compiled, const std::uint32_t index, Task &next);
+
+    /** @brief Tries to schedule every successor of a node */
+    void scheduleSuccessors(Node * const node, Task &next);
+
+    /** @brief Tries to schedule every successor of a compiled graph node */
+    void scheduleCompiledSuccessors(CompiledGraph &compiled, const std::uint32_t index, Task &next);
+
+    /** @brief Tries to schedule a node of a static schedule, a ready node is sent to its assigned worker */
+    void scheduleStaticNode(CompiledGraph &compiled, const std::uint32_t index, Task &next);
+
+    /** @brief Make a ready node the continuation 'next' when it is not yet set or of lower priority, else push it into the local queue */
+    void readyNode(Node * const node, Task &next);
+
+    /** @brief Helper used to process a Static node of a compiled graph */
+    [[nodiscard]] std::uint32_t dispatchCompiledStaticNode(CompiledGraph &compiled, Node * const node, Task &next);
 
     /** @brief Helper used to process a Static node */
-    [[nodiscard]] std::uint32_t dispatchStaticNode(Node * const node);
+    [[nodiscard]] std::uint32_t dispatchStaticNode(Node * const node, Task &next);
 
     /** @brief Helper used to process a Dynamic node */
-    [[nodiscard]] std::uint32_t dispatchDynamicNode(Node * const node);
+    [[nodiscard]] std::uint32_t dispatchDynamicNode(Node * const node, Task &next);
 
     /** @brief Helper used to process a Switch node */
-    [[nodiscard]] std::uint32_t dispatchSwitchNode(Node * const node);
+    [[nodiscard]] std::uint32_t dispatchSwitchNode(Node * const node, Task &next);
 
     /** @brief Helper used to process a Graph node */
-    [[nodiscard]] std::uint32_t dispatchGraphNode(Node * const node);
+    [[nodiscard]] std::uint32_t dispatchGraphNode(Node * const node, Task &next);
+
+    /** @brief Helper used to process a Coroutine node, starting its coroutine or resuming it, returns a null join count while suspended */
+    [[nodiscard]] std::uint32_t dispatchCoroutineNode(Node * const node, Task &next);
 };
 
-static_assert_sizeof(Flow::Worker, 6 * Core::CacheLineSize);
+static_assert_sizeof(Flow::Worker, (6 + 4 * Flow::PriorityCount) * Core::CacheLineSize);
 static_assert_alignof_double_cacheline(Flow::Worker);
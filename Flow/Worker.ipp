@@ -3,14 +3,18 @@
  * @ Description: Worker
  */
 
-inline void Flow::Worker::start(void)
+inline void Flow::Worker::start(const std::size_t index, std::vector<std::uint32_t> &&cpus)
 {
     const auto state = _state.load();
 
     if (state != State::Stopped)
         throw std::logic_error("Flow::Worker::start: Worker already running");
     _state = State::Running;
-    _cache.thd = std::thread([this] { run(); });
+    _cache.thd = std::thread([this, index, cpus = std::move(cpus)] {
+        const auto pinned = !cpus.empty() && CpuTopology::PinCurrentThread(cpus);
+        _cache.parent->workerStarted(index, pinned && cpus.size() == 1ul ? cpus.front() : Scheduler::NoCpu);
+        run();
+    });
 }
 
 inline void Flow::Worker::stop(void) noexcept
@@ -37,12 +41,182 @@ inline void Flow::Worker::join(void) noexcept
         _cache.thd.join();
 }
 
-inline void Flow::Worker::scheduleNode(Node * const node)
+inline bool Flow::Worker::pop(Task &task) noexcept
+{
+    for (auto level = PriorityCount; level--;) {
+        // Empty queues are skipped without touching their bottom index, a stale inbox size only delays its tasks
+        if ((!_queues[level].empty() && _queues[level].pop(task)) || (!_inboxes[level].empty() && _inboxes[level].steal(task))) {
+            WorkerCounters::Increment(_counters.localPops);
+            return true;
+        }
+    }
+    return false;
+}
+
+inline bool Flow::Worker::steal(Task &task) noexcept
+{
+    for (auto level = PriorityCount; level--;) {
+        if ((!_queues[level].empty() && _queues[level].steal(task)) || (!_inboxes[level].empty() && _inboxes[level].steal(task)))
+            return true;
+    }
+    return false;
+}
+
+inline std::size_t Flow::Worker::taskCount(void) const noexcept
+{
+    std::size_t count { 0ul };
+
+    for (auto level = 0ul; level != PriorityCount; ++level)
+        count += _queues[level].size() + _inboxes[level].size();
+    return count;
+}
+
+inline bool Flow::Worker::stealFromOthers(Task &task) noexcept
+{
+    if (_cache.parent->steal(*this, task)) {
+        WorkerCounters::Increment(_counters.steals);
+        return true;
+    }
+    WorkerCounters::Increment(_counters.failedSteals);
+    return false;
+}
+
+inline bool Flow::Worker::acquire(Task &task, bool &stolen) noexcept
+{
+    if (pop(task))
+        stolen = false;
+    else if (stealFromOthers(task))
+        stolen = true;
+    else
+        return false;
+    return true;
+}
+
+inline void Flow::Worker::scheduleNode(Node * const node, Task &next)
 {
     if (const auto count = node->linkedFrom.size(); count && count == ++node->joined) {
         node->joined = 0;
-        _cache.parent->schedule(node);
+        readyNode(node, next);
+    }
+}
+
+inline void Flow::Worker::scheduleCompiledNode(CompiledGraph &compiled, const std::uint32_t index, Task &next)
+{
+    if (compiled.joinCounts[index] == ++compiled.joined[index]) {
+        compiled.joined[index] = 0;
+        readyNode(compiled.nodes[index], next);
+    }
+}
+
+inline void Flow::Worker::scheduleSuccessors(Node * const node, Task &next)
+{
+    if (const auto compiled = node->root->compiled(); compiled)
+        scheduleCompiledSuccessors(*compiled, node->index, next);
+    else {
+        for (Node * const link : node->linkedTo)
+            scheduleNode(link, next);
+    }
+}
+
+inline void Flow::Worker::scheduleCompiledSuccessors(CompiledGraph &compiled, const std::uint32_t index, Task &next)
+{
+    if (const auto &staticSchedule = compiled.staticSchedule; staticSchedule) {
+        // Successors of the same lane are reached through the lane order
+        const auto worker = staticSchedule->workers[index];
+        if (const auto laneNext = staticSchedule->laneNext[index]; laneNext != CompiledGraph::StaticSchedule::NoIndex)
+            scheduleStaticNode(compiled, laneNext, next);
+        for (auto it = compiled.successorsBegin(index), end = compiled.successorsEnd(index); it != end; ++it) {
+            if (staticSchedule->workers[*it] != worker)
+                scheduleStaticNode(compiled, *it, next);
+        }
+    } else {
+        for (auto it = compiled.successorsBegin(index), end = compiled.successorsEnd(index); it != end; ++it)
+            scheduleCompiledNode(compiled, *it, next);
+    }
+}
+
+inline void Flow::Worker::scheduleStaticNode(CompiledGraph &compiled, const std::uint32_t index, Task &next)
+{
+    auto &staticSchedule = *compiled.staticSchedule;
+
+    if (const auto joinCount = staticSchedule.joinCounts[index]; joinCount != 1u) {
+        if (joinCount != ++compiled.joined[index])
+            return;
+        compiled.joined[index] = 0;
+    }
+    if (const auto worker = staticSchedule.workers[index]; worker == _cache.parent->workerIndex(*this))
+        readyNode(compiled.nodes[index], next);
+    else
+        _cache.parent->schedule(Task(compiled.nodes[index]), worker);
+}
+
+inline void Flow::Worker::readyNode(Node * const node, Task &next)
+{
+    // The first ready successor of highest priority is executed right after the current node, the others stay on this worker until stolen
+    if (!next)
+        next = Task(node);
+    else {
+        Task ready(node);
+        if (ready.node()->level > next.node()->level)
+            std::swap(ready, next);
+        push(ready);
+        _cache.parent->wakeUpIdleWorker();
+    }
+}
+
+inline void Flow::Worker::submit(const Task task) noexcept
+{
+    lockInbox();
+    _inboxes[QueueIndex(task)].push(task);
+    unlockInbox();
+}
+
+inline void Flow::Worker::submit(const Task * const begin, const Task * const end) noexcept
+{
+    lockInbox();
+    // Consecutive tasks of the same priority are published at once
+    for (auto it = begin; it != end;) {
+        const auto level = QueueIndex(*it);
+        auto last = it + 1;
+        while (last != end && QueueIndex(*last) == level)
+            ++last;
+        _inboxes[level].push(it, last);
+        it = last;
     }
+    unlockInbox();
+}
+
+inline void Flow::Worker::lockInbox(void) noexcept
+{
+    while (_inboxLock.exchange(true, std::memory_order_acquire)) {
+        _inboxRetries.fetch_add(1u, std::memory_order_relaxed);
+        while (_inboxLock.load(std::memory_order_relaxed))
+            CpuPause();
+    }
+}
+
+inline bool Flow::Worker::stealHalf(Worker &thief, Task &task) noexcept
+{
+    if (!steal(task))
+        return false;
+    for (auto count = taskCount() / 2; count; --count) {
+        Task extra;
+        if (!steal(extra))
+            break;
+        thief.push(extra);
+    }
+    return true;
+}
+
+inline std::size_t Flow::Worker::random(void) noexcept
+{
+    // xorshift64*
+    auto x = _cache.seed;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    _cache.seed = x;
+    return static_cast<std::size_t>((x * 0x2545F4914F6CDD1Dull) >> 32);
 }
 
 inline void Flow::Worker::wakeUp(const State state) noexcept
@@ -51,37 +225,97 @@ inline void Flow::Worker::wakeUp(const State state) noexcept
     atomic_sync::atomic_notify_one(&_state);
 }
 
-inline void Flow::Worker::blockingGraphSchedule(Graph &graph)
+inline bool Flow::Worker::tryWakeUp(void) noexcept
 {
-    _cache.parent->schedule(graph);
-    while (graph.running() && state() == State::Running) {
-        if (Task task; _queue.pop(task) || _cache.parent->steal(task))
-            work(task);
-        else
-            std::this_thread::yield();
+    auto state = State::IDLE;
+
+    if (!_state.compare_exchange_strong(state, State::Running))
+        return false;
+    atomic_sync::atomic_notify_one(&_state);
+    if (const auto issuer = Current(); issuer && issuer->_cache.parent == _cache.parent)
+        WorkerCounters::Increment(issuer->_counters.wakeUpsIssued);
+    else
+        _cache.parent->externalWakeUpIssued();
+    return true;
+}
+
+inline bool Flow::Worker::isBypassed(const Node * const node) const noexcept
+{
+    return node->bypass.load(std::memory_order_relaxed)
+        || (!node->critical && node->root->deadlineMissed() && _cache.parent->deadlinePolicy() == Scheduler::DeadlinePolicy::BypassNonCritical);
+}
+
+inline std::uint32_t Flow::Worker::scheduleNestedGraph(Node * const node, Graph &graph)
+{
+    // The node is suspended, the worker completing the nested run resumes it
+    graph.setParentNode(node, _cache.dispatchStart, _cache.dispatchStolen);
+    _cache.parent->schedule(graph, node->root->deadline());
+    return 0u;
+}
+
+inline void Flow::Worker::resumeNode(Node * const node, const Deadline start, const bool stolen)
+{
+    const auto root = node->root;
+    Task next;
+
+    // The node spans from its dispatch to the completion of its nested run
+    if (start != Deadline()) {
+        if (const auto compiled = root->compiled(); compiled && compiled->staticSchedule)
+            compiled->recordCost(node->index, static_cast<std::uint64_t>(std::chrono::nanoseconds(DeadlineClock::now() - start).count()));
+        if (TracingEnabled && _cache.trace) [[unlikely]]
+            trace(Task(node), start, stolen);
     }
+    if (root->hasDeadline())
+        _cache.parent->checkDeadline(node);
+    notifyNode(Task(node));
+    scheduleSuccessors(node, next);
+    if (next)
+        push(next);
+    root->childJoined();
 }
 
-inline std::uint32_t Flow::Worker::dispatchStaticNode(Node * const node)
+inline bool Flow::Worker::IsFused(const Node * const node, const CompiledGraph * const compiled) noexcept
 {
-    if (!node->bypass.load())
+    return node->fused && (!compiled || !compiled->staticSchedule);
+}
+
+inline std::uint32_t Flow::Worker::dispatchStaticNode(Node * const node, Task &next)
+{
+    if (!isBypassed(node))
         std::get<static_cast<std::size_t>(NodeType::Static)>(node->workData)();
-    for (Node * const link : node->linkedTo)
-        scheduleNode(link);
+    if (IsFused(node, nullptr))
+        next = Task(node->linkedTo[0]);
+    else if (!node->root->selfJoined())
+        scheduleSuccessors(node, next);
+    return 1u;
+}
+
+inline std::uint32_t Flow::Worker::dispatchCompiledStaticNode(CompiledGraph &compiled, Node * const node, Task &next)
+{
+    const auto index = node->index;
+
+    if (!isBypassed(node))
+        compiled.staticWorks[index]();
+    if (IsFused(node, &compiled))
+        next = Task(node->linkedTo[0]);
+    else
+        scheduleCompiledSuccessors(compiled, index, next);
     return 1u;
 }
 
-inline std::uint32_t Flow::Worker::dispatchDynamicNode(Node * const node)
+inline std::uint32_t Flow::Worker::dispatchDynamicNode(Node * const node, Task &next)
 {
-    if (!node->bypass.load()) {
+    if (!isBypassed(node)) {
         auto &dynamic = std::get<static_cast<std::size_t>(NodeType::Dynamic)>(node->workData);
         dynamic.func(dynamic.graph);
-        blockingGraphSchedule(dynamic.graph);
+        if (dynamic.graph && dynamic.graph.size())
+            return scheduleNestedGraph(node, dynamic.graph);
     }
+    scheduleSuccessors(node, next);
     return 1u;
 }
 
-inline std::uint32_t Flow::Worker::dispatchSwitchNode(Node * const node)
+inline std::uint32_t Flow::Worker::dispatchSwitchNode(Node * const node, Task &next)
 {
     auto &switchTask = std::get<static_cast<std::size_t>(NodeType::Switch)>(node->workData);
     const auto index = switchTask.func();
@@ -94,7 +328,10 @@ inline std::uint32_t Flow::Worker::dispatchSwitchNode(Node * const node)
         throw std::logic_error("Invalid switch task return index"));
     coreAssert(switchTask.joinCounts.size() == count,
         throw std::logic_error("Invalid switch task preprocessing, expected " + std::to_string(count) + " join counts but have " + std::to_string(switchTask.joinCounts.size())));
-    scheduleNode(node->linkedTo[index]);
+    if (const auto compiled = node->root->compiled(); compiled)
+        scheduleCompiledNode(*compiled, compiled->successorsBegin(node->index)[index], next);
+    else
+        scheduleNode(node->linkedTo[index], next);
     for (std::uint32_t i = 0; i < count; ++i) {
         if (i != index)
             joinCount += switchTask.joinCounts[i];
@@ -104,13 +341,67 @@ inline std::uint32_t Flow::Worker::dispatchSwitchNode(Node * const node)
     return joinCount;
 }
 
-inline std::uint32_t Flow::Worker::dispatchGraphNode(Node * const node)
+inline std::uint32_t Flow::Worker::drainNode(Node * const node, Task &next)
+{
+    if (node->workData.index() == static_cast<std::size_t>(NodeType::Switch)) {
+        // No branch will be selected, so every node of every branch is joined with the switch node
+        std::uint32_t joinCount = 1u;
+        for (const auto count : std::get<static_cast<std::size_t>(NodeType::Switch)>(node->workData).joinCounts)
+            joinCount += count;
+        return joinCount;
+    }
+    if (node->workData.index() == static_cast<std::size_t>(NodeType::Coroutine)) {
+        // A suspended coroutine is destroyed where it stands
+        if (auto &coroutine = std::get<static_cast<std::size_t>(NodeType::Coroutine)>(node->workData); coroutine.handle)
+            std::exchange(coroutine.handle, nullptr).destroy();
+    }
+    if (node->root->selfJoined()) {
+        // The work joins the successors itself and skips everything else on a cancelled run
+        std::get<static_cast<std::size_t>(NodeType::Static)>(node->workData)();
+        return 1u;
+    }
+    scheduleSuccessors(node, next);
+    return 1u;
+}
+
+inline std::uint32_t Flow::Worker::dispatchGraphNode(Node * const node, Task &next)
 {
-    if (!node->bypass.load()) {
+    if (!isBypassed(node)) {
         auto &graph = std::get<static_cast<std::size_t>(NodeType::Graph)>(node->workData);
-        blockingGraphSchedule(graph);
+        if (graph && graph.size())
+            return scheduleNestedGraph(node, graph);
+    }
+    scheduleSuccessors(node, next);
+    return 1u;
+}
+
+inline std::uint32_t Flow::Worker::dispatchCoroutineNode(Node * const node, Task &next)
+{
+    auto &coroutine = std::get<static_cast<std::size_t>(NodeType::Coroutine)>(node->workData);
+    bool completed = false;
+
+    if (!coroutine.handle) {
+        if (isBypassed(node)) {
+            scheduleSuccessors(node, next);
+            return 1u;
+        }
+        coroutine.handle = coroutine.func().release();
+        // A moved-from coroutine has no frame to resume
+        if (!coroutine.handle)
+            throw std::logic_error("Flow::Worker::dispatchCoroutineNode: Coroutine node returned an empty coroutine");
+        coroutine.handle.promise().setNode(node);
+    }
+    coroutine.handle.promise().setCompletedFlag(&completed);
+    coroutine.handle.resume();
+    if (!completed) {
+        // Suspended: the coroutine may already be resumed by another worker, the node must not be accessed anymore
+        return 0u;
     }
-    for (const auto link : node->linkedTo)
-        scheduleNode(link);
+    const auto handle = std::exchange(coroutine.handle, nullptr);
+    const auto exception = handle.promise().exception();
+    handle.destroy();
+    if (exception)
+        std::rethrow_exception(exception);
+    scheduleSuccessors(node, next);
     return 1u;
 }
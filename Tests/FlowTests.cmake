@@ -5,7 +5,13 @@ find_package(GTest REQUIRED)
 get_filename_component(FlowTestsDir ${CMAKE_CURRENT_LIST_FILE} PATH)
 
 set(FlowTestsSources
+    ${FlowTestsDir}/tests_Algorithms.cpp
+    ${FlowTestsDir}/tests_Graph.cpp
+    ${FlowTestsDir}/tests_Pipeline.cpp
     ${FlowTestsDir}/tests_Scheduler.cpp
+    ${FlowTestsDir}/tests_StaticGraph.cpp
+    ${FlowTestsDir}/tests_Trace.cpp
+    ${FlowTestsDir}/tests_WorkStealingDeque.cpp
 )
 
 add_executable(${PROJECT_NAME} ${FlowTestsSources})
@@ -0,0 +1,80 @@
+/**
+ * @ Author: Matthieu Moinvaziri
+ * @ Description: Unit tests of parallel algorithms
+ */
+
+#include <gtest/gtest.h>
+
+#include <numeric>
+#include <random>
+
+#include <Flow/Algorithms.hpp>
+
+TEST(Algorithms, ParallelFor)
+{
+    Flow::Scheduler scheduler(4);
+    std::vector<std::size_t> values(10000, 0ul);
+
+    Flow::ParallelFor(scheduler, 0ul, values.size(), [&values](const std::size_t index) { values[index] = index * 2ul; });
+    for (auto i = 0ul; i < values.size(); ++i)
+        ASSERT_EQ(values[i], i * 2ul);
+    Flow::ParallelFor(scheduler, values.begin(), values.end(), [](std::size_t &value) { ++value; }, Flow::ParallelOptions { 64ul });
+    for (auto i = 0ul; i < values.size(); ++i)
+        ASSERT_EQ(values[i], i * 2ul + 1ul);
+    // A range not larger than the grain size runs on the calling thread
+    const auto caller = std::this_thread::get_id();
+    Flow::ParallelFor(scheduler, 0, 16, [caller](const int) { ASSERT_EQ(std::this_thread::get_id(), caller); }, Flow::ParallelOptions { 16ul });
+}
+
+TEST(Algorithms, ParallelReduceAndTransform)
+{
+    Flow::Scheduler scheduler(4);
+    std::vector<std::uint64_t> values(10000);
+    std::vector<std::uint64_t> squares(values.size());
+
+    std::iota(values.begin(), values.end(), 1u);
+    const auto sum = Flow::ParallelReduce(scheduler, values.begin(), values.end(), std::uint64_t(0u), std::plus<>());
+    ASSERT_EQ(sum, 10000u * 10001u / 2u);
+    Flow::ParallelTransform(scheduler, values.begin(), values.end(), squares.begin(), [](const std::uint64_t value) { return value * value; });
+    for (auto i = 0ul; i < values.size(); ++i)
+        ASSERT_EQ(squares[i], values[i] * values[i]);
+    ASSERT_EQ(Flow::ParallelReduce(scheduler, 0, 0, 1, std::multiplies<>()), 1);
+}
+
+TEST(Algorithms, ParallelSort)
+{
+    Flow::Scheduler scheduler(4);
+    std::mt19937 engine(42u);
+    std::vector<int> values(10007);
+
+    for (auto &value : values)
+        value = static_cast<int>(engine() % 1000u);
+    auto expected = values;
+    std::sort(expected.begin(), expected.end(), std::greater<>());
+    Flow::ParallelSort(scheduler, values.begin(), values.end(), std::greater<>(), Flow::ParallelOptions { 16ul, 8ul });
+    ASSERT_EQ(values, expected);
+}
+
+TEST(Algorithms, CompositeNodes)
+{
+    Flow::Scheduler scheduler(4);
+    Flow::Graph graph;
+    std::vector<int> values(4096);
+    int sum = 0;
+    int runs = 0;
+
+    auto fill = graph.emplace([&values, &runs] { std::fill(values.begin(), values.end(), ++runs); });
+    auto scale = Flow::ParallelFor(graph, values.begin(), values.end(), [](int &value) { value *= 2; });
+    auto reduce = Flow::ParallelReduce(graph, values.begin(), values.end(), sum, 0, std::plus<>(), Flow::ParallelOptions { 32ul });
+    auto sort = Flow::ParallelSort(graph, values.begin(), values.end(), std::less<>(), Flow::ParallelOptions { 32ul, 4ul });
+    fill.precede(scale);
+    scale.precede(reduce);
+    reduce.precede(sort);
+    // Composite nodes rewind their range on every run
+    for (auto i = 1; i <= 3; ++i) {
+        scheduler.schedule(graph);
+        graph.wait();
+        ASSERT_EQ(sum, 4096 * 2 * i);
+        ASSERT_TRUE(std::is_sorted(values.begin(), values.end()));
+    }
+}
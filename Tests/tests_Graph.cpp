@@ -0,0 +1,172 @@
+/**
+ * @ Author: Matthieu Moinvaziri
+ * @ Description: Unit tests of Graph
+ */
+
+#include <gtest/gtest.h>
+
+#include <Flow/Scheduler.hpp>
+
+namespace
+{
+    /** @brief Memory resource counting its live allocations */
+    class CountingResource : public std::pmr::memory_resource
+    {
+    public:
+        std::size_t allocations { 0u };
+        std::size_t liveBytes { 0u };
+
+    private:
+        void *do_allocate(const std::size_t bytes, const std::size_t alignment) override
+        {
+            ++allocations;
+            liveBytes += bytes;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void *data, const std::size_t bytes, const std::size_t alignment) override
+        {
+            liveBytes -= bytes;
+            std::pmr::new_delete_resource()->deallocate(data, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+    };
+}
+
+TEST(Graph, ArenaLayout)
+{
+    Flow::Graph graph;
+    Flow::Task first = graph.emplace(Flow::EmptyWork);
+    Flow::Task previous = first;
+
+    // Nodes of the first chunk are contiguous in emplace order
+    for (auto i = 1u; i < Flow::NodeArena::MinChunkCapacity; ++i) {
+        auto task = graph.emplace(Flow::EmptyWork);
+        ASSERT_EQ(task.node(), previous.node() + 1);
+        previous = task;
+    }
+    ASSERT_EQ(graph.size(), Flow::NodeArena::MinChunkCapacity);
+}
+
+TEST(Graph, MemoryResource)
+{
+    CountingResource resource;
+
+    {
+        Flow::Graph graph(&resource);
+        std::atomic<int> trigger = 0;
+        ASSERT_EQ(resource.allocations, 1u);
+        for (auto i = 0; i < 100; ++i)
+            graph.emplace([&trigger] { ++trigger; });
+        ASSERT_GT(resource.allocations, 1u);
+
+        // Clearing keeps the largest chunk for the next nodes
+        const auto allocations = resource.allocations;
+        graph.clear();
+        for (auto i = 0; i < 10; ++i)
+            graph.emplace([&trigger] { ++trigger; });
+        ASSERT_EQ(resource.allocations, allocations);
+
+        Flow::Scheduler scheduler(2);
+        scheduler.schedule(graph);
+        graph.wait();
+        ASSERT_EQ(trigger, 10);
+    }
+    ASSERT_EQ(resource.liveBytes, 0u);
+}
+
+TEST(Graph, CriticalPathPriorities)
+{
+    Flow::Graph graph;
+    auto a = graph.emplace([] {});
+    auto b = graph.emplace([] {});
+    auto c = graph.emplace([] {});
+    auto d = graph.emplace([] {});
+    auto e = graph.emplace([] {});
+    auto f = graph.emplace([] {});
+
+    // a -> b -> c -> d is the critical path, e and f have slack
+    a.precede(b);
+    b.precede(c);
+    c.precede(d);
+    a.precede(e);
+    e.precede(d);
+    graph.preprocess();
+    ASSERT_EQ(a.priority(), Flow::Priority::High);
+    ASSERT_EQ(c.priority(), Flow::Priority::High);
+    ASSERT_EQ(d.priority(), Flow::Priority::High);
+    ASSERT_EQ(e.priority(), Flow::Priority::Normal);
+    ASSERT_EQ(f.priority(), Flow::Priority::Normal);
+
+    // Explicit priorities are kept, returning to the automatic one requires a preprocess
+    b.setPriority(Flow::Priority::Low);
+    ASSERT_EQ(b.priority(), Flow::Priority::Low);
+    graph.preprocess();
+    ASSERT_EQ(b.priority(), Flow::Priority::Low);
+    b.setPriority(Flow::Priority::Auto);
+    graph.preprocess();
+    ASSERT_EQ(b.priority(), Flow::Priority::High);
+}
+
+TEST(Graph, IncrementalPreprocess)
+{
+    constexpr auto NodeCount = 200;
+    Flow::Graph graph;
+    std::vector<Flow::Task> tasks;
+    std::uint64_t seed = 42;
+    const auto random = [&seed](const std::size_t max) {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        return static_cast<std::size_t>(seed >> 33) % max;
+    };
+    const auto joinCounts = [&tasks] {
+        std::vector<std::uint32_t> counts;
+        for (auto &task : tasks) {
+            if (task.type() == Flow::NodeType::Switch) {
+                for (const auto count : std::get<static_cast<std::size_t>(Flow::NodeType::Switch)>(task.node()->workData).joinCounts)
+                    counts.push_back(count);
+            }
+        }
+        return counts;
+    };
+
+    // Random DAG edited by steps, each incremental preprocess must match a full one
+    for (auto i = 0; i < NodeCount; ++i) {
+        if (i % 10)
+            tasks.push_back(graph.emplace([] {}));
+        else
+            tasks.push_back(graph.emplace([] { return 0ul; }));
+    }
+    for (auto step = 0; step < 20; ++step) {
+        for (auto edge = 0; edge < 20; ++edge) {
+            const auto from = random(NodeCount - 1);
+            const auto to = from + 1 + random(NodeCount - from - 1);
+            tasks[from].precede(tasks[to]);
+        }
+        if (step % 5 == 4)
+            tasks.push_back(graph.emplace([] {}));
+        graph.preprocess();
+        const auto incremental = joinCounts();
+        graph.invalidate();
+        graph.preprocess();
+        ASSERT_EQ(incremental, joinCounts());
+    }
+}
+
+TEST(Graph, DeepSwitchBranch)
+{
+    constexpr auto Depth = 200000;
+    Flow::Graph graph;
+
+    // Branches are counted iteratively, a deep branch can't overflow the stack
+    auto branch = graph.emplace([] { return 0ul; });
+    auto previous = graph.emplace([] {});
+    branch.precede(previous);
+    for (auto i = 1; i < Depth; ++i) {
+        auto node = graph.emplace([] {});
+        previous.precede(node);
+        previous = node;
+    }
+    graph.preprocess();
+    ASSERT_EQ(std::get<static_cast<std::size_t>(Flow::NodeType::Switch)>(branch.node()->workData).joinCounts[0], Depth);
+}
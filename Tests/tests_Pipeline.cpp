@@ -0,0 +1,68 @@
+/**
+ * @ Author: Matthieu Moinvaziri
+ * @ Description: Unit tests of Pipeline
+ */
+
+#include <gtest/gtest.h>
+
+#include <Flow/Pipeline.hpp>
+
+TEST(Pipeline, SerialParallelSerial)
+{
+    constexpr std::size_t TokenCount = 1000;
+
+    Flow::Scheduler scheduler(4);
+    Flow::Pipeline<std::size_t> pipeline(4);
+    std::vector<std::size_t> output;
+
+    pipeline.stage(Flow::StageType::Serial, [](auto &flow) {
+        if (flow.token() == TokenCount)
+            flow.stop();
+        else
+            flow.scratch() = flow.token();
+    })
+    .stage(Flow::StageType::Parallel, [](auto &flow) {
+        flow.scratch() = flow.scratch(0) * flow.scratch(0);
+    })
+    .stage(Flow::StageType::Serial, [&output](auto &flow) {
+        ASSERT_EQ(flow.scratch(1), flow.token() * flow.token());
+        output.push_back(flow.token());
+    });
+    ASSERT_EQ(pipeline.stageCount(), 3);
+    ASSERT_EQ(pipeline.graph().size(), 5);
+    for (auto run = 1ul; run <= 10ul; ++run) {
+        scheduler.schedule(pipeline.graph()).wait();
+        ASSERT_EQ(pipeline.tokenCount(), TokenCount);
+        ASSERT_EQ(output.size(), run * TokenCount);
+        for (auto i = 0ul; i < TokenCount; ++i)
+            ASSERT_EQ(output[(run - 1ul) * TokenCount + i], i);
+    }
+}
+
+TEST(Pipeline, SingleLine)
+{
+    Flow::Scheduler scheduler(2);
+    Flow::Pipeline pipeline(1);
+    std::size_t sum = 0;
+
+    pipeline.stage(Flow::StageType::Serial, [](auto &flow) { if (flow.token() == 100) flow.stop(); })
+        .stage(Flow::StageType::Parallel, [&sum](auto &flow) { sum += flow.token(); });
+    scheduler.schedule(pipeline.graph()).wait();
+    ASSERT_EQ(sum, 4950);
+}
+
+TEST(Pipeline, Errors)
+{
+    Flow::Scheduler scheduler(4);
+    Flow::Pipeline pipeline(4);
+
+    ASSERT_THROW(Flow::Pipeline(0), std::logic_error);
+    ASSERT_THROW(static_cast<void>(pipeline.graph()), std::logic_error);
+    ASSERT_THROW(pipeline.stage(Flow::StageType::Parallel, [](auto &) {}), std::logic_error);
+    pipeline.stage(Flow::StageType::Serial, [](auto &flow) { if (flow.token() == 1000) flow.stop(); })
+        .stage(Flow::StageType::Parallel, [](auto &flow) { if (flow.token() == 10) throw std::runtime_error("token"); });
+    scheduler.schedule(pipeline.graph());
+    ASSERT_THROW(pipeline.graph().wait(), std::runtime_error);
+    ASSERT_LT(pipeline.tokenCount(), 1000);
+    ASSERT_THROW(pipeline.stage(Flow::StageType::Serial, [](auto &) {}), std::logic_error);
+}
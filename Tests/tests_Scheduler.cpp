@@ -5,6 +5,11 @@
 
 #include <gtest/gtest.h>
 
+#ifdef __linux__
+# include <poll.h>
+# include <sys/eventfd.h>
+#endif
+
 #include <Flow/Scheduler.hpp>
 
 TEST(Scheduler, InitDestroy)
@@ -72,6 +77,131 @@ TEST(Scheduler, NotifyTask)
     ASSERT_EQ(trigger, 6);
 }
 
+TEST(Scheduler, NotificationPolicies)
+{
+    Flow::Scheduler scheduler(1, 4);
+    Flow::Graph graph;
+    std::atomic<int> trigger = 0;
+
+    for (auto i = 0; i < 16; ++i)
+        graph.emplace(Flow::EmptyWork, [&trigger] { ++trigger; });
+
+    // DropOldest: only the last notifications are kept
+    scheduler.setNotificationPolicy(Flow::Scheduler::NotificationPolicy::DropOldest);
+    scheduler.schedule(graph);
+    graph.wait();
+    ASSERT_EQ(scheduler.processNotifications(), 4u);
+    ASSERT_EQ(trigger, 4);
+    ASSERT_EQ(scheduler.stats().total().notificationsDropped, 12u);
+
+    // Grow: the queue chains larger segments, nothing is lost
+    scheduler.setNotificationPolicy(Flow::Scheduler::NotificationPolicy::Grow);
+    scheduler.schedule(graph);
+    graph.wait();
+    ASSERT_EQ(scheduler.processNotifications(), 16u);
+    ASSERT_EQ(trigger, 20);
+    ASSERT_EQ(scheduler.processNotifications(), 0u);
+
+    // Coalesce: each node is pending only once across runs
+    scheduler.setNotificationPolicy(Flow::Scheduler::NotificationPolicy::Coalesce);
+    for (auto i = 0; i < 3; ++i) {
+        scheduler.schedule(graph);
+        graph.wait();
+    }
+    ASSERT_EQ(scheduler.processNotifications(), 16u);
+    ASSERT_EQ(trigger, 36);
+    ASSERT_EQ(scheduler.stats().total().notificationsCoalesced, 32u);
+
+    // Any queue size is rounded up to a power of 2
+    Flow::Scheduler rounded(1, 3);
+    rounded.setNotificationPolicy(Flow::Scheduler::NotificationPolicy::DropOldest);
+    rounded.schedule(graph);
+    graph.wait();
+    ASSERT_EQ(rounded.processNotifications(), 4u);
+}
+
+TEST(Scheduler, NotificationException)
+{
+    Flow::Scheduler scheduler(1);
+    Flow::Graph graph;
+    std::atomic<int> trigger = 0;
+
+    auto previous = graph.emplace(Flow::EmptyWork, [&trigger] { ++trigger; });
+    for (auto i = 1; i < 16; ++i) {
+        auto next = graph.emplace(Flow::EmptyWork, [&trigger, i] {
+            if (i == 4)
+                throw std::runtime_error("notification");
+            ++trigger;
+        });
+        previous.precede(next);
+        previous = next;
+    }
+    scheduler.schedule(graph).wait();
+    // The notifications following the throwing one are kept for the next call
+    ASSERT_THROW(scheduler.processNotifications(), std::runtime_error);
+    ASSERT_EQ(trigger, 4);
+    ASSERT_EQ(scheduler.processNotifications(), 11u);
+    ASSERT_EQ(trigger, 15);
+}
+
+#ifdef __linux__
+TEST(Scheduler, NotificationHandle)
+{
+    Flow::Scheduler scheduler(2);
+    Flow::Graph graph;
+    std::atomic<int> trigger = 0;
+
+    for (auto i = 0; i < 16; ++i)
+        graph.emplace(Flow::EmptyWork, [&trigger] { ++trigger; });
+
+    const auto handle = scheduler.enableNotificationHandle();
+    ASSERT_NE(handle, Flow::Scheduler::InvalidNotificationHandle);
+    ASSERT_EQ(scheduler.enableNotificationHandle(), handle);
+    pollfd event { handle, POLLIN, 0 };
+    ASSERT_EQ(::poll(&event, 1, 0), 1); // Signalled once enabled, in case notifications were already pending
+    ASSERT_EQ(scheduler.processNotifications(), 0u);
+    ASSERT_EQ(::poll(&event, 1, 0), 0);
+
+    for (auto run = 1; run <= 2; ++run) {
+        scheduler.schedule(graph);
+        graph.wait();
+        ASSERT_EQ(::poll(&event, 1, 1000), 1);
+        eventfd_t signals = 0u;
+        ASSERT_EQ(::eventfd_read(handle, &signals), 0);
+        ASSERT_EQ(signals, 1u); // A burst of notifications signals the handle once
+        ASSERT_EQ(scheduler.processNotifications(), 16u);
+        ASSERT_EQ(trigger, run * 16);
+        ASSERT_EQ(::poll(&event, 1, 0), 0);
+    }
+    scheduler.disableNotificationHandle();
+    ASSERT_EQ(scheduler.notificationHandle(), Flow::Scheduler::InvalidNotificationHandle);
+}
+
+TEST(Scheduler, NotificationHandleInterleaved)
+{
+    constexpr std::size_t Runs = 2000ul;
+    Flow::Scheduler scheduler(2);
+    Flow::Graph graph;
+    std::atomic<std::size_t> trigger = 0ul;
+
+    graph.emplace(Flow::EmptyWork, [&trigger] { ++trigger; });
+    pollfd event { scheduler.enableNotificationHandle(), POLLIN, 0 };
+    std::thread producer([&scheduler, &graph] {
+        for (auto i = 0ul; i < Runs; ++i) {
+            scheduler.schedule(graph);
+            graph.wait();
+        }
+    });
+    // Notifications are queued while the loop drains, the handle must stay readable as long as one is pending
+    auto processed = scheduler.processNotifications();
+    while (processed < Runs && ::poll(&event, 1, 1000) == 1)
+        processed += scheduler.processNotifications();
+    producer.join();
+    ASSERT_EQ(processed, Runs);
+    ASSERT_EQ(trigger, Runs);
+}
+#endif
+
 TEST(Scheduler, MergeTask)
 {
     Flow::Scheduler scheduler;
@@ -233,4 +363,718 @@ TEST(Scheduler, RepeatBasics)
     scheduler.schedule(graph);
     graph.wait();
     ASSERT_EQ(trigger, 3);
-}
\ No newline at end of file
+}
+
+TEST(Scheduler, BulkSchedule)
+{
+    Flow::Scheduler scheduler(4);
+    Flow::Graph graph;
+    std::atomic<int> trigger = 0;
+    auto sink = graph.emplace([&trigger] { trigger += 1000; });
+
+    // Many roots are submitted as a single batch
+    for (auto i = 0; i < 300; ++i)
+        graph.emplace([&trigger] { ++trigger; }).precede(sink);
+    for (auto i = 1; i <= 4; ++i) {
+        scheduler.schedule(graph);
+        graph.wait();
+        ASSERT_EQ(trigger, i * 1300);
+    }
+}
+
+TEST(Scheduler, StealHalfPolicy)
+{
+    Flow::Scheduler scheduler(4, Flow::Scheduler::StealPolicy { .attempts = 2u, .stealHalf = true });
+    Flow::Graph graph;
+    std::atomic<int> trigger = 0;
+
+    auto source = graph.emplace(Flow::EmptyWork);
+    auto sink = graph.emplace([&trigger] { trigger += 1000; });
+    for (auto i = 0; i < 512; ++i) {
+        auto leaf = graph.emplace([&trigger] { ++trigger; });
+        source.precede(leaf);
+        leaf.precede(sink);
+    }
+    for (auto i = 1; i <= 4; ++i) {
+        scheduler.schedule(graph);
+        graph.wait();
+        ASSERT_EQ(trigger, i * 1512);
+    }
+}
+
+TEST(Scheduler, SearchingWorker)
+{
+    std::atomic<int> trigger = 0;
+    const auto waitWorkers = [](const Flow::Scheduler &scheduler, const std::size_t idle, const std::size_t searching) {
+        const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (scheduler.idleWorkerCount() != idle || scheduler.searchingWorkerCount() != searching) {
+            if (std::chrono::steady_clock::now() > timeout)
+                return false;
+            std::this_thread::yield();
+        }
+        return true;
+    };
+    Flow::Graph graph;
+
+    auto source = graph.emplace(Flow::EmptyWork);
+    for (auto i = 0; i < 64; ++i) {
+        auto leaf = graph.emplace([&trigger] { ++trigger; });
+        source.precede(leaf);
+    }
+    {
+        Flow::Scheduler scheduler(4, Flow::Scheduler::StealPolicy { .attempts = 4u, .yields = 16u, .keepSearching = true });
+        for (auto i = 1; i <= 50; ++i) {
+            scheduler.schedule(graph).wait();
+            ASSERT_EQ(trigger, i * 64);
+        }
+
+        // Once idle, a single worker keeps searching so that new runs start without any wake-up
+        ASSERT_TRUE(waitWorkers(scheduler, 3ul, 1ul));
+        const auto wakeUps = scheduler.stats().externalWakeUps;
+        scheduler.schedule(graph).wait();
+        ASSERT_EQ(trigger, 51 * 64);
+        ASSERT_EQ(scheduler.stats().externalWakeUps, wakeUps);
+    }
+
+    // Without the rule, every worker parks once its search failed
+    Flow::Scheduler scheduler(4, Flow::Scheduler::StealPolicy { .attempts = 4u });
+    scheduler.schedule(graph).wait();
+    ASSERT_EQ(trigger, 52 * 64);
+    ASSERT_TRUE(waitWorkers(scheduler, 4ul, 0ul));
+}
+
+TEST(Scheduler, ChainLocality)
+{
+    Flow::Scheduler scheduler(4);
+    Flow::Graph graph;
+    std::thread::id ids[16] {};
+    Flow::Task previous;
+
+    for (auto i = 0; i < 16; ++i) {
+        auto task = graph.emplace([&ids, i] { ids[i] = std::this_thread::get_id(); });
+        if (previous)
+            previous.precede(task);
+        previous = task;
+    }
+    scheduler.schedule(graph);
+    graph.wait();
+    for (auto i = 1; i < 16; ++i)
+        ASSERT_EQ(ids[i], ids[0]);
+}
+
+TEST(Scheduler, CompiledGraph)
+{
+    Flow::Scheduler scheduler;
+    std::atomic<int> trigger = 0;
+    Flow::Graph graph;
+
+    auto a = graph.emplace([&trigger]() -> bool { return trigger >= 1000; });
+    auto b = graph.emplace([&trigger] { trigger += 1000; });
+    auto c = graph.emplace([&trigger] { trigger += 1; });
+    auto d = graph.emplace([&trigger] { trigger += 1; });
+    auto e = graph.emplace([&trigger] { trigger += 10; });
+    b.succeed(a); // 0 returned
+    c.succeed(a); // 1 returned
+    e.succeed(c);
+
+    graph.compile();
+    ASSERT_TRUE(graph.isCompiled());
+    ASSERT_EQ(graph.compiled()->staticCount(), 4u);
+    scheduler.schedule(graph);
+    graph.wait();
+    ASSERT_EQ(trigger, 1001);
+    for (auto i = 1; i <= 100; ++i) {
+        scheduler.schedule(graph);
+        graph.wait();
+        ASSERT_EQ(trigger, 1001 + i * 12);
+    }
+
+    // Static works are stored by the compiled graph, replacing one keeps the compiled form
+    d.setWork([&trigger] { trigger += 2; });
+    ASSERT_TRUE(graph.isCompiled());
+    scheduler.schedule(graph);
+    graph.wait();
+    ASSERT_EQ(trigger, 1001 + 100 * 12 + 13);
+    d.setWork([&trigger] { trigger += 1; });
+
+    // Any topology change drops the compiled form
+    auto f = graph.emplace([&trigger] { trigger = 0; });
+    ASSERT_FALSE(graph.isCompiled());
+    // The reset must follow every other node, including the independent root 'd'
+    e.precede(f);
+    d.precede(f);
+    graph.compile();
+    scheduler.schedule(graph);
+    graph.wait();
+    ASSERT_EQ(trigger, 0);
+}
+
+TEST(Scheduler, StaticSchedule)
+{
+    Flow::Scheduler scheduler(4);
+    Flow::Graph graph;
+    std::atomic<int> counters[64] {};
+    std::atomic<int> trigger = 0;
+    auto source = graph.emplace([&trigger] { trigger = 0; });
+    auto sink = graph.emplace([&trigger, &counters] {
+        for (auto &counter : counters)
+            trigger += counter;
+    });
+
+    // Four chains of 16 nodes between a source and a sink
+    for (auto i = 0; i < 4; ++i) {
+        auto previous = source;
+        for (auto j = 0; j < 16; ++j) {
+            auto &counter = counters[i * 16 + j];
+            auto task = graph.emplace([&counter, j] {
+                for (auto k = 0; k < (j + 1) * 100; ++k)
+                    std::atomic_signal_fence(std::memory_order_seq_cst);
+                ++counter;
+            });
+            previous.precede(task);
+            previous = task;
+        }
+        previous.precede(sink);
+    }
+    graph.compile(Flow::ScheduleMode::Static);
+    ASSERT_TRUE(graph.compiled()->staticSchedule);
+    for (auto i = 1; i <= 50; ++i) {
+        scheduler.schedule(graph);
+        graph.wait();
+        ASSERT_EQ(trigger, i * 64);
+    }
+    ASSERT_EQ(graph.compiled()->staticSchedule->workerCount, 4u);
+    ASSERT_NE(graph.compiled()->staticSchedule->plannedCost, 0u);
+
+    // Switch nodes can't be replayed statically
+    auto branch = graph.emplace([]() -> bool { return false; });
+    branch.precede(source);
+    graph.compile(Flow::ScheduleMode::Static);
+    ASSERT_FALSE(graph.compiled()->staticSchedule);
+    scheduler.schedule(graph);
+    graph.wait();
+    ASSERT_EQ(trigger, 51 * 64);
+}
+
+TEST(Scheduler, DynamicTaskSuccessor)
+{
+    Flow::Scheduler scheduler;
+    Flow::Graph graph;
+    std::atomic<int> trigger = 0;
+
+    auto dynamic = graph.emplace([&trigger](Flow::Graph &sub) {
+        sub.clear();
+        sub.emplace([&trigger] { ++trigger; });
+    });
+    auto after = graph.emplace([&trigger] { trigger = trigger * 10; });
+    dynamic.precede(after);
+
+    scheduler.schedule(graph);
+    graph.wait();
+    ASSERT_EQ(trigger, 10);
+}
+
+TEST(Scheduler, Future)
+{
+    Flow::Scheduler scheduler(2);
+    Flow::Graph graph;
+    std::atomic<bool> release = false;
+    std::atomic<int> trigger = 0;
+
+    graph.emplace([&release, &trigger] {
+        while (!release)
+            std::this_thread::yield();
+        ++trigger;
+    });
+    auto future = scheduler.schedule(graph);
+    ASSERT_TRUE(future.valid());
+    ASSERT_FALSE(future.ready());
+    ASSERT_FALSE(future.waitFor(std::chrono::milliseconds(1)));
+    ASSERT_FALSE(graph.waitFor(std::chrono::milliseconds(1)));
+    release = true;
+    future.wait();
+    ASSERT_TRUE(future.ready());
+    ASSERT_EQ(trigger, 1);
+    graph.wait();
+    ASSERT_TRUE(scheduler.waitGraphsFor(std::chrono::seconds(1)));
+    ASSERT_TRUE(scheduler.schedule(graph).waitFor(std::chrono::seconds(1)));
+    ASSERT_EQ(trigger, 2);
+    Flow::Graph empty;
+    ASSERT_TRUE(scheduler.schedule(empty).ready());
+}
+
+TEST(Scheduler, CompleteCallback)
+{
+    Flow::Scheduler scheduler;
+    Flow::Graph graph;
+    std::atomic<int> trigger = 0;
+    std::atomic<int> completed = 0;
+
+    graph.emplace([&trigger] { ++trigger; });
+    scheduler.schedule(graph, [&scheduler, &graph, &completed] {
+        ++completed;
+        // Chain another run from the callback
+        scheduler.schedule(graph, [&completed] { ++completed; });
+    });
+    while (completed != 2)
+        std::this_thread::yield();
+    scheduler.waitGraphs();
+    ASSERT_EQ(trigger, 2);
+    ASSERT_EQ(completed, 2);
+}
+
+TEST(Scheduler, DeadlineMiss)
+{
+    Flow::Scheduler scheduler(2);
+    Flow::Graph graph;
+    std::atomic<int> trigger = 0;
+
+    scheduler.setDeadlinePolicy(Flow::Scheduler::DeadlinePolicy::BypassNonCritical);
+    auto a = graph.emplace([&trigger] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        trigger += 1;
+    }, "a");
+    auto b = graph.emplace([&trigger] { trigger += 10; }, "b");
+    auto c = graph.emplace([&trigger] { trigger += 100; }, "c");
+    c.setCritical(true);
+    a.precede(b);
+    b.precede(c);
+
+    scheduler.schedule(graph, Flow::DeadlineClock::now() + std::chrono::seconds(10)).wait();
+    ASSERT_EQ(trigger, 111);
+    ASSERT_EQ(scheduler.deadlineMissCount(), 0);
+    ASSERT_FALSE(scheduler.lastDeadlineMiss());
+
+    scheduler.schedule(graph, Flow::DeadlineClock::now() + std::chrono::milliseconds(1)).wait();
+    ASSERT_EQ(trigger, 212);
+    ASSERT_EQ(scheduler.deadlineMissCount(), 1);
+    ASSERT_EQ(scheduler.lastDeadlineMiss().name(), "a");
+    ASSERT_FALSE(scheduler.hasDeadlineGraphs());
+
+    // Each repeat gets the budget of the first run from its own start
+    auto repeats = 0;
+    graph.setRepeatCallback([&repeats] { return ++repeats < 40; });
+    scheduler.schedule(graph, Flow::DeadlineClock::now() + std::chrono::milliseconds(100)).wait();
+    ASSERT_EQ(repeats, 40);
+    ASSERT_EQ(scheduler.deadlineMissCount(), 1);
+}
+
+TEST(Scheduler, Stats)
+{
+    Flow::Scheduler scheduler(2);
+    Flow::Graph graph;
+    std::atomic<int> trigger = 0;
+
+    auto source = graph.emplace(Flow::EmptyWork);
+    for (auto i = 0; i < 64; ++i) {
+        auto leaf = graph.emplace([&trigger] { ++trigger; });
+        source.precede(leaf);
+    }
+    for (auto i = 0; i < 4; ++i) {
+        scheduler.schedule(graph);
+        graph.wait();
+    }
+    ASSERT_EQ(trigger, 4 * 64);
+
+    const auto stats = scheduler.stats();
+    ASSERT_EQ(stats.workers.size(), scheduler.workerCount());
+    const auto total = stats.total();
+    ASSERT_EQ(total.tasksExecuted, 4u * 65u);
+    // Every executed task is either a continuation, popped or stolen
+    ASSERT_LE(total.localPops + total.steals, total.tasksExecuted);
+    ASSERT_GT(total.runningTime.count(), 0);
+    ASSERT_EQ(total.notificationsDropped, 0u);
+}
+
+TEST(Scheduler, ExceptionFailsRun)
+{
+    Flow::Scheduler scheduler(2);
+    Flow::Graph graph;
+    std::atomic<int> trigger = 0;
+    bool shouldThrow = true;
+
+    auto a = graph.emplace([&trigger] { ++trigger; });
+    auto b = graph.emplace([&trigger, &shouldThrow] {
+        if (shouldThrow)
+            throw std::runtime_error("b failed");
+        trigger += 10;
+    });
+    auto c = graph.emplace([&trigger] { trigger += 100; });
+    a.precede(b);
+    b.precede(c);
+
+    // The successors of the failed node are drained and the exception is rethrown by wait
+    auto future = scheduler.schedule(graph);
+    ASSERT_THROW(future.wait(), std::runtime_error);
+    ASSERT_THROW(graph.wait(), std::runtime_error);
+    ASSERT_TRUE(graph.exception());
+    ASSERT_EQ(trigger, 1);
+
+    // The next run starts clean
+    shouldThrow = false;
+    scheduler.schedule(graph).wait();
+    ASSERT_FALSE(graph.exception());
+    ASSERT_EQ(trigger, 112);
+}
+
+TEST(Scheduler, ExceptionInSwitchAndNestedGraph)
+{
+    Flow::Scheduler scheduler(2);
+    Flow::Graph graph;
+    std::atomic<int> trigger = 0;
+
+    auto a = graph.emplace([]() -> int { throw std::runtime_error("switch failed"); });
+    auto b = graph.emplace([&trigger] { ++trigger; });
+    auto c = graph.emplace([&trigger] { ++trigger; });
+    auto d = graph.emplace([&trigger] { ++trigger; });
+    a.precede(b);
+    a.precede(c);
+    c.precede(d);
+    ASSERT_THROW(scheduler.schedule(graph).wait(), std::runtime_error);
+    ASSERT_EQ(trigger, 0);
+
+    // A failure inside a dynamic node fails its parent graph
+    Flow::Graph parent;
+    auto dynamic = parent.emplace([](Flow::Graph &sub) {
+        sub.clear();
+        sub.emplace([] { throw std::logic_error("nested failed"); });
+    });
+    auto after = parent.emplace([&trigger] { ++trigger; });
+    dynamic.precede(after);
+    ASSERT_THROW(scheduler.schedule(parent).wait(), std::logic_error);
+    ASSERT_EQ(trigger, 0);
+}
+
+TEST(Scheduler, Cancel)
+{
+    Flow::Scheduler scheduler(2);
+    Flow::Graph graph;
+    std::atomic<int> trigger = 0;
+
+    auto a = graph.emplace([&trigger, &graph] {
+        ++trigger;
+        graph.cancel();
+    });
+    auto previous = a;
+    for (auto i = 0; i < 16; ++i) {
+        auto next = graph.emplace([&trigger] { trigger += 10; });
+        previous.precede(next);
+        previous = next;
+    }
+    graph.setRepeatCallback([] { return true; });
+
+    // Cancelled runs complete without executing their remaining nodes nor repeating, and don't throw
+    scheduler.schedule(graph).wait();
+    ASSERT_EQ(trigger, 1);
+    ASSERT_FALSE(graph.exception());
+    scheduler.schedule(graph).wait();
+    ASSERT_EQ(trigger, 2);
+
+    // A future only cancels its own run, not a later run of the same graph
+    Flow::Graph blocked;
+    std::atomic<bool> release = true;
+    auto wait = blocked.emplace([&release] { while (!release) std::this_thread::yield(); });
+    auto add = blocked.emplace([&trigger] { trigger += 10; });
+    wait.precede(add);
+    auto stale = scheduler.schedule(blocked);
+    stale.wait();
+    release = false;
+    auto current = scheduler.schedule(blocked);
+    stale.cancel();
+    release = true;
+    current.wait();
+    ASSERT_EQ(trigger, 22);
+    release = false;
+    current = scheduler.schedule(blocked);
+    current.cancel();
+    release = true;
+    current.wait();
+    ASSERT_EQ(trigger, 22);
+}
+
+TEST(Scheduler, NestedContinuations)
+{
+    constexpr auto Depth = 8;
+    Flow::Scheduler scheduler(1);
+    std::atomic<int> trigger = 0;
+    Flow::Graph levels[Depth];
+
+    // Each level runs a node then the next level, a single worker is never blocked by the nesting
+    for (auto i = Depth - 1; i >= 0; --i) {
+        auto node = levels[i].emplace([&trigger] { ++trigger; });
+        if (i + 1 < Depth) {
+            auto nested = levels[i].emplace(levels[i + 1]);
+            node.precede(nested);
+        }
+    }
+    Flow::Graph graph;
+    auto before = graph.emplace([&trigger] { trigger += 100; });
+    auto nested = graph.emplace(levels[0]);
+    auto after = graph.emplace([&trigger] { trigger = trigger * 2; });
+    before.precede(nested);
+    nested.precede(after);
+    for (auto i = 0; i < 3; ++i) {
+        trigger = 0;
+        scheduler.schedule(graph).wait();
+        ASSERT_EQ(trigger, (100 + Depth) * 2);
+    }
+}
+
+TEST(Scheduler, NestedCancel)
+{
+    Flow::Scheduler scheduler(2);
+    Flow::Graph graph;
+    std::atomic<int> trigger = 0;
+
+    // Cancelling the parent run drains the nodes of its nested run too
+    auto dynamic = graph.emplace([&trigger, &graph](Flow::Graph &sub) {
+        sub.clear();
+        auto a = sub.emplace([&trigger, &graph] {
+            ++trigger;
+            graph.cancel();
+        });
+        auto b = sub.emplace([&trigger] { trigger += 10; });
+        a.precede(b);
+    });
+    auto after = graph.emplace([&trigger] { trigger += 100; });
+    dynamic.precede(after);
+    scheduler.schedule(graph).wait();
+    ASSERT_EQ(trigger, 1);
+}
+
+TEST(Scheduler, CoroutineTask)
+{
+    Flow::Scheduler scheduler(1);
+    Flow::Graph graph, nested;
+    std::atomic<int> trigger = 0;
+
+    nested.emplace([&trigger] { trigger += 10; });
+    auto coroutine = graph.emplace([&trigger, &nested]() -> Flow::Coroutine {
+        ++trigger;
+        co_await nested;
+        co_await nested;
+        trigger = trigger * 2;
+    });
+    auto after = graph.emplace([&trigger] { trigger += 100; });
+    coroutine.precede(after);
+    ASSERT_EQ(coroutine.type(), Flow::NodeType::Coroutine);
+    for (auto i = 0; i < 3; ++i) {
+        trigger = 0;
+        scheduler.schedule(graph).wait();
+        ASSERT_EQ(trigger, 21 * 2 + 100);
+    }
+}
+
+TEST(Scheduler, CoroutineExternalAwaiter)
+{
+    /** @brief Awaiter resumed by an external thread once 'ready' is set */
+    struct Awaiter
+    {
+        std::atomic<bool> &ready;
+        std::thread thread {};
+
+        bool await_ready(void) const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            thread = std::thread([this, handle] {
+                while (!ready)
+                    std::this_thread::yield();
+                handle.resume();
+            });
+        }
+        void await_resume(void) { thread.join(); }
+    };
+
+    Flow::Scheduler scheduler(1);
+    Flow::Graph graph;
+    std::atomic<bool> ready = false;
+    std::atomic<int> trigger = 0;
+
+    // The single worker is free to execute the node releasing the awaiter while the coroutine is suspended
+    graph.emplace([&]() -> Flow::Coroutine {
+        co_await Awaiter { ready };
+        EXPECT_NE(Flow::Worker::Current(), nullptr);
+        ++trigger;
+    });
+    graph.emplace([&ready] { ready = true; });
+    scheduler.schedule(graph).wait();
+    ASSERT_EQ(trigger, 1);
+}
+
+TEST(Scheduler, CoroutineException)
+{
+    Flow::Scheduler scheduler(2);
+    Flow::Graph graph, nested;
+    std::atomic<int> trigger = 0;
+
+    nested.emplace([] { throw std::runtime_error("nested"); });
+    auto coroutine = graph.emplace([&trigger, &nested]() -> Flow::Coroutine {
+        try {
+            co_await nested;
+        } catch (const std::runtime_error &) {
+            ++trigger;
+        }
+        throw std::logic_error("coroutine");
+    });
+    auto after = graph.emplace([&trigger] { trigger += 100; });
+    coroutine.precede(after);
+    scheduler.schedule(graph);
+    ASSERT_THROW(graph.wait(), std::logic_error);
+    ASSERT_EQ(trigger, 1);
+}
+
+TEST(Scheduler, EmptyCoroutine)
+{
+    Flow::Scheduler scheduler(2);
+    Flow::Graph graph;
+    std::atomic<int> trigger = 0;
+    const auto make = []() -> Flow::Coroutine { co_return; };
+
+    auto coroutine = graph.emplace([&make] {
+        auto created = make();
+        auto moved = std::move(created);
+        return created;
+    });
+    auto after = graph.emplace([&trigger] { ++trigger; });
+    coroutine.precede(after);
+    for (auto run = 0; run < 2; ++run) {
+        scheduler.schedule(graph);
+        ASSERT_THROW(graph.wait(), std::logic_error);
+        ASSERT_EQ(trigger, 0);
+    }
+}
+
+TEST(Scheduler, Priorities)
+{
+    Flow::Scheduler scheduler(1);
+    Flow::Graph graph;
+    std::vector<Flow::Priority> order;
+    const Flow::Priority priorities[] {
+        Flow::Priority::Normal, Flow::Priority::Low, Flow::Priority::High, Flow::Priority::Normal, Flow::Priority::High, Flow::Priority::Low
+    };
+
+    // A single worker executes the ready successors by decreasing priority
+    auto source = graph.emplace([] {});
+    for (const auto priority : priorities) {
+        auto node = graph.emplace([&order, priority] { order.push_back(priority); });
+        node.setPriority(priority);
+        source.precede(node);
+    }
+    scheduler.schedule(graph).wait();
+    ASSERT_EQ(order.size(), std::size(priorities));
+    ASSERT_TRUE(std::is_sorted(order.begin(), order.end(), std::greater<>()));
+}
+
+TEST(Scheduler, ChainFusion)
+{
+    constexpr auto ChainSize = 64;
+    Flow::Scheduler scheduler(2);
+    Flow::Graph graph;
+    std::atomic<int> trigger = 0;
+    std::atomic<int> notified = 0;
+    Flow::Task chain[ChainSize];
+
+    // Two chains joined by a node with two predecessors, which can't be fused
+    for (auto i = 0; i < ChainSize; ++i) {
+        chain[i] = graph.emplace([&trigger] { ++trigger; }, [&notified] { ++notified; });
+        if (i && i != ChainSize / 2)
+            chain[i - 1].precede(chain[i]);
+    }
+    auto sink = graph.emplace([&trigger] { trigger += 1000; });
+    chain[ChainSize / 2 - 1].precede(sink);
+    chain[ChainSize - 1].precede(sink);
+    chain[1].setBypass(true);
+    graph.setChainFusion(true);
+    ASSERT_TRUE(graph.chainFusion());
+    for (auto compiled = 0; compiled < 2; ++compiled) {
+        for (auto i = 1; i <= 10; ++i) {
+            trigger = 0;
+            scheduler.schedule(graph).wait();
+            ASSERT_EQ(trigger, ChainSize - 1 + 1000);
+            ASSERT_EQ(scheduler.processNotifications(), ChainSize);
+        }
+        graph.compile();
+    }
+    ASSERT_EQ(notified, ChainSize * 20);
+
+    // A cancelled fused chain still completes its run
+    chain[3].setWork([&trigger, &graph] { ++trigger; graph.cancel(); });
+    trigger = 0;
+    scheduler.schedule(graph).wait();
+    ASSERT_LT(trigger, ChainSize);
+}
+
+TEST(Scheduler, HierarchicalSteal)
+{
+    // Two packages of two caches, each cache holds two cores of two SMT siblings (core N has CPUs N and N + 8)
+    std::vector<Flow::CpuInfo> cpus;
+    for (std::uint32_t id = 0u; id < 16u; ++id) {
+        const auto core = id % 8u;
+        cpus.push_back(Flow::CpuInfo { id, core, core / 2u * 2u, core / 4u * 4u });
+    }
+    Flow::CpuTopology topology(std::move(cpus));
+    ASSERT_EQ(topology.size(), 16);
+    ASSERT_EQ(topology.cpus()[0].id, 0u);
+    ASSERT_EQ(topology.cpus()[1].id, 1u); // Physical cores before siblings
+    ASSERT_EQ(topology.cpus()[2].id, 8u);
+    ASSERT_EQ(Flow::CpuTopology::Distance(*topology.find(0u), *topology.find(8u)), Flow::CpuDistance::Sibling);
+    ASSERT_EQ(Flow::CpuTopology::Distance(*topology.find(0u), *topology.find(1u)), Flow::CpuDistance::SharedCache);
+    ASSERT_EQ(Flow::CpuTopology::Distance(*topology.find(0u), *topology.find(2u)), Flow::CpuDistance::Package);
+    ASSERT_EQ(Flow::CpuTopology::Distance(*topology.find(0u), *topology.find(4u)), Flow::CpuDistance::Remote);
+
+    Flow::Scheduler::PlacementPolicy placement;
+    placement.topology = topology;
+    placement.excludedCpus = { 1u, 9u }; // Core kept free for the I/O thread
+    ASSERT_THROW(Flow::Scheduler(1, Flow::Scheduler::PlacementPolicy { topology, { 1u }, { 1u } }), std::logic_error);
+    Flow::Scheduler scheduler(Flow::Scheduler::AutoWorkerCount, placement);
+    ASSERT_EQ(scheduler.workerCount(), 14);
+    // Worker 0 runs on CPU 0: its sibling (worker 1) comes first, then the other cache of its package (workers 2 to 5), then remote ones
+    const auto order = scheduler.stealOrder(0);
+    ASSERT_EQ(order.size(), 13);
+    ASSERT_EQ(order[0], 1ul);
+    for (auto i = 1ul; i < order.size(); ++i)
+        ASSERT_EQ(order[i] >= 6ul, i >= 5ul);
+
+    // Whatever the pinning outcome on this machine, the workers execute graphs
+    std::atomic<int> trigger = 0;
+    Flow::Graph graph;
+    for (auto i = 0; i < 64; ++i)
+        graph.emplace([&trigger] { ++trigger; });
+    scheduler.schedule(graph).wait();
+    ASSERT_EQ(trigger, 64);
+
+    // Workers that can't be pinned steal in flat order, even if their intended CPUs are siblings
+    std::vector<Flow::CpuInfo> unavailable;
+    for (std::uint32_t id = 0u; id < 4u; ++id)
+        unavailable.push_back(Flow::CpuInfo { 2048u + id, 2048u + id % 3u, 2048u + id % 3u, 2048u + id % 3u });
+    Flow::Scheduler unpinned(4, Flow::Scheduler::PlacementPolicy {
+        .topology = Flow::CpuTopology(std::move(unavailable)),
+        .cpus = { 2048u, 2049u, 2050u, 2051u }
+    });
+    for (auto i = 0ul; i < unpinned.workerCount(); ++i)
+        ASSERT_EQ(unpinned.workerCpu(i), Flow::Scheduler::NoCpu);
+    ASSERT_EQ(unpinned.stealOrder(0), (std::vector<std::size_t> { 1ul, 2ul, 3ul }));
+}
+
+TEST(Scheduler, DetectedPlacement)
+{
+    const auto topology = Flow::CpuTopology::Detect();
+    ASSERT_FALSE(topology.empty());
+    Flow::Scheduler::PlacementPolicy placement;
+    if (topology.size() > 1ul)
+        placement.excludedCpus = { topology.cpus().back().id };
+    Flow::Scheduler scheduler(2, placement);
+    for (auto i = 0ul; i < scheduler.workerCount(); ++i) {
+        const auto cpu = scheduler.workerCpu(i);
+        if (cpu != Flow::Scheduler::NoCpu) {
+            ASSERT_NE(topology.find(cpu), nullptr);
+            ASSERT_TRUE(placement.excludedCpus.empty() || cpu != placement.excludedCpus.front());
+        }
+    }
+    std::atomic<int> trigger = 0;
+    Flow::Graph graph;
+    for (auto i = 0; i < 16; ++i)
+        graph.emplace([&trigger] { ++trigger; });
+    scheduler.schedule(graph).wait();
+    ASSERT_EQ(trigger, 16);
+}
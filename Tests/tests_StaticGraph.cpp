@@ -0,0 +1,111 @@
+/**
+ * @ Author: Matthieu Moinvaziri
+ * @ Description: Unit tests of StaticGraph
+ */
+
+#include <gtest/gtest.h>
+
+#include <Flow/StaticGraph.hpp>
+
+namespace
+{
+    /** @brief Node appending its identifier to a shared trace */
+    template<int Id>
+    struct TraceNode
+    {
+        std::atomic<int> *trace { nullptr };
+
+        void operator()(void) { trace->fetch_add(Id); }
+    };
+
+    using A = TraceNode<1>;
+    using B = TraceNode<10>;
+    using C = TraceNode<100>;
+
+    /** @brief Node checking that its predecessors are all executed */
+    struct D
+    {
+        std::atomic<int> *trace { nullptr };
+        int seen { 0 };
+
+        void operator()(void) { seen = trace->load(); }
+    };
+
+    using Diamond = Flow::StaticGraph<
+        Flow::StaticNodes<A, B, C, D>,
+        Flow::StaticEdges<
+            Flow::StaticEdge<A, B>,
+            Flow::StaticEdge<A, C>,
+            Flow::StaticEdge<B, D>,
+            Flow::StaticEdge<C, D>
+        >
+    >;
+}
+
+TEST(StaticGraph, Diamond)
+{
+    Flow::Scheduler scheduler(4);
+    std::atomic<int> trace = 0;
+    Diamond graph(A { &trace }, B { &trace }, C { &trace }, D { &trace });
+
+    static_assert(Diamond::NodeCount == 4);
+    static_assert(Diamond::IndexOf<C> == 2);
+    ASSERT_EQ(graph.graph().size(), 4);
+    for (auto i = 1; i <= 100; ++i) {
+        scheduler.schedule(graph.graph()).wait();
+        ASSERT_EQ(trace, i * 111);
+        ASSERT_EQ(graph.get<D>().seen, i * 111);
+    }
+}
+
+TEST(StaticGraph, IndependentNodes)
+{
+    Flow::Scheduler scheduler(2);
+    std::atomic<int> trace = 0;
+    Flow::StaticGraph<Flow::StaticNodes<A, B, C>, Flow::StaticEdges<>> graph(A { &trace }, B { &trace }, C { &trace });
+
+    scheduler.schedule(graph.graph()).wait();
+    ASSERT_EQ(trace, 111);
+}
+
+TEST(StaticGraph, Exception)
+{
+    struct Throwing
+    {
+        void operator()(void) { throw std::runtime_error("static node failed"); }
+    };
+    using Failing = Flow::StaticGraph<
+        Flow::StaticNodes<A, Throwing, C>,
+        Flow::StaticEdges<Flow::StaticEdge<A, Throwing>, Flow::StaticEdge<Throwing, C>>
+    >;
+    Flow::Scheduler scheduler(2);
+    std::atomic<int> trace = 0;
+    Failing graph(A { &trace }, Throwing {}, C { &trace });
+
+    ASSERT_THROW(scheduler.schedule(graph.graph()).wait(), std::runtime_error);
+    ASSERT_EQ(trace, 1);
+}
+
+TEST(StaticGraph, Links)
+{
+    Flow::Scheduler scheduler(2);
+    std::atomic<int> trace = 0;
+    Flow::StaticGraph<Flow::StaticNodes<A, B, C>, Flow::StaticEdges<Flow::StaticEdge<A, B>>> graph(A { &trace }, B { &trace }, C { &trace });
+    Flow::Task a(graph.graph().begin()->node());
+    Flow::Task c((graph.graph().begin() + 2)->node());
+
+    // Proxies are linked like any graph so the critical path is seen by the scheduler
+    ASSERT_EQ(a.priority(), Flow::Priority::High);
+    ASSERT_EQ(c.priority(), Flow::Priority::Normal);
+    ASSERT_EQ(a.node()->linkedTo.size(), 1);
+    ASSERT_EQ(c.node()->linkedFrom.size(), 0);
+
+    // Neither fusion nor compilation joins the successors a second time
+    graph.graph().setChainFusion(true);
+    graph.graph().compile();
+    ASSERT_FALSE(graph.graph().isCompiled());
+    for (auto i = 1; i <= 10; ++i) {
+        scheduler.schedule(graph.graph()).wait();
+        ASSERT_EQ(trace, i * 111);
+    }
+}
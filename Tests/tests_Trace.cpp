@@ -0,0 +1,108 @@
+/**
+ * @ Author: Matthieu Moinvaziri
+ * @ Description: Unit tests of Trace
+ */
+
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+#include <Flow/Scheduler.hpp>
+
+TEST(Trace, RingBuffer)
+{
+    Flow::TraceBuffer buffer(4);
+    Flow::TraceEvent event;
+
+    for (auto i = 0; i < 6; ++i) {
+        event.iteration = static_cast<std::uint32_t>(i);
+        buffer.record(event);
+    }
+    ASSERT_EQ(buffer.size(), 4);
+    ASSERT_EQ(buffer.recordCount(), 6);
+    std::uint32_t expected = 2u;
+    buffer.forEach([&expected](const Flow::TraceEvent &event) { ASSERT_EQ(event.iteration, expected++); });
+    ASSERT_EQ(expected, 6u);
+    buffer.clear();
+    ASSERT_EQ(buffer.size(), 0);
+    ASSERT_ANY_THROW(Flow::TraceBuffer(3));
+}
+
+TEST(Trace, SchedulerTrace)
+{
+    if constexpr (!Flow::TracingEnabled)
+        GTEST_SKIP();
+
+    Flow::Scheduler scheduler(2);
+    Flow::Graph graph;
+
+    scheduler.enableTracing();
+    ASSERT_TRUE(scheduler.tracingEnabled());
+    auto a = graph.emplace(Flow::EmptyWork, "a");
+    auto b = graph.emplace(Flow::EmptyWork, "b\"quoted\"");
+    a.precede(b);
+    for (auto i = 0; i < 2; ++i) {
+        scheduler.schedule(graph);
+        graph.wait();
+    }
+
+    std::size_t count = 0ul;
+    std::uint32_t iterations[2] {};
+    for (auto i = 0ul; i < scheduler.workerCount(); ++i) {
+        scheduler.traceBuffer(i).forEach([&](const Flow::TraceEvent &event) {
+            ASSERT_EQ(event.worker, i);
+            ASSERT_EQ(event.type, Flow::NodeType::Static);
+            ASSERT_LE(event.begin, event.end);
+            ASSERT_LT(event.iteration, 2u);
+            ++iterations[event.iteration];
+            ++count;
+        });
+    }
+    ASSERT_EQ(count, 4ul);
+    ASSERT_EQ(iterations[0], 2u);
+    ASSERT_EQ(iterations[1], 2u);
+
+    std::ostringstream stream;
+    scheduler.exportTrace(stream);
+    const auto json = stream.str();
+    ASSERT_NE(json.find("\"traceEvents\""), std::string::npos);
+    ASSERT_NE(json.find("\"name\":\"a\""), std::string::npos);
+    ASSERT_NE(json.find("\"name\":\"b\\\"quoted\\\"\""), std::string::npos);
+
+    scheduler.disableTracing();
+    ASSERT_FALSE(scheduler.tracingEnabled());
+    scheduler.schedule(graph);
+    graph.wait();
+}
+
+TEST(Trace, NestedGraphTrace)
+{
+    if constexpr (!Flow::TracingEnabled)
+        GTEST_SKIP();
+
+    Flow::Scheduler scheduler(2);
+    Flow::Graph graph;
+    Flow::Graph nested;
+
+    nested.emplace([] { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }, "child");
+    graph.emplace(nested, "nested");
+    graph.compile(Flow::ScheduleMode::Static);
+    scheduler.enableTracing();
+    scheduler.schedule(graph);
+    graph.wait();
+
+    // The suspended node is recorded once resumed, it spans the whole nested run
+    std::int64_t childDuration = 0, nestedDuration = 0;
+    for (auto i = 0ul; i < scheduler.workerCount(); ++i) {
+        scheduler.traceBuffer(i).forEach([&](const Flow::TraceEvent &event) {
+            if (event.type == Flow::NodeType::Graph)
+                nestedDuration = event.end - event.begin;
+            else
+                childDuration = event.end - event.begin;
+        });
+    }
+    ASSERT_GT(childDuration, 0);
+    ASSERT_GE(nestedDuration, childDuration);
+    const auto compiled = graph.compiled();
+    ASSERT_GT(compiled->staticSchedule->costs[compiled->typeOffsets[static_cast<std::size_t>(Flow::NodeType::Graph)]], 0u);
+}
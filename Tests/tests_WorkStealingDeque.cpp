@@ -0,0 +1,100 @@
+/**
+ * @ Author: Matthieu Moinvaziri
+ * @ Description: Unit tests of WorkStealingDeque
+ */
+
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <Flow/WorkStealingDeque.hpp>
+
+TEST(WorkStealingDeque, OwnerLIFO)
+{
+    Flow::WorkStealingDeque<int> deque(2);
+    int value = 0;
+
+    ASSERT_FALSE(deque.pop(value));
+    for (auto i = 0; i < 10; ++i)
+        deque.push(i);
+    ASSERT_EQ(deque.size(), 10);
+    ASSERT_GE(deque.capacity(), 10);
+    for (auto i = 9; i >= 0; --i) {
+        ASSERT_TRUE(deque.pop(value));
+        ASSERT_EQ(value, i);
+    }
+    ASSERT_FALSE(deque.pop(value));
+    ASSERT_TRUE(deque.empty());
+}
+
+TEST(WorkStealingDeque, BulkPush)
+{
+    Flow::WorkStealingDeque<int> deque(2);
+    int values[100];
+    int value = 0;
+
+    for (auto i = 0; i < 100; ++i)
+        values[i] = i;
+    deque.push(0);
+    deque.push(values + 1, values + 100);
+    ASSERT_EQ(deque.size(), 100);
+    ASSERT_EQ(deque.capacity(), 128);
+    for (auto i = 0; i < 50; ++i) {
+        ASSERT_TRUE(deque.steal(value));
+        ASSERT_EQ(value, i);
+    }
+    for (auto i = 99; i >= 50; --i) {
+        ASSERT_TRUE(deque.pop(value));
+        ASSERT_EQ(value, i);
+    }
+    ASSERT_TRUE(deque.empty());
+}
+
+TEST(WorkStealingDeque, ThiefFIFO)
+{
+    Flow::WorkStealingDeque<int> deque(4);
+    int value = 0;
+
+    for (auto i = 0; i < 10; ++i)
+        deque.push(i);
+    for (auto i = 0; i < 10; ++i) {
+        ASSERT_TRUE(deque.steal(value));
+        ASSERT_EQ(value, i);
+    }
+    ASSERT_FALSE(deque.steal(value));
+}
+
+TEST(WorkStealingDeque, ConcurrentSteal)
+{
+    constexpr auto Count = 100000;
+    constexpr auto ThiefCount = 4;
+    Flow::WorkStealingDeque<int> deque(8);
+    std::vector<std::atomic<int>> hits(Count);
+    std::atomic<bool> done { false };
+    std::vector<std::thread> thieves;
+
+    for (auto i = 0; i < ThiefCount; ++i) {
+        thieves.emplace_back([&deque, &hits, &done] {
+            int value;
+            while (!done.load()) {
+                if (deque.steal(value))
+                    ++hits[value];
+            }
+            while (deque.steal(value))
+                ++hits[value];
+        });
+    }
+    for (auto i = 0; i < Count; ++i) {
+        deque.push(i);
+        if (int value; (i % 3) == 0 && deque.pop(value))
+            ++hits[value];
+    }
+    for (int value; deque.pop(value);)
+        ++hits[value];
+    done = true;
+    for (auto &thief : thieves)
+        thief.join();
+    for (auto &hit : hits)
+        ASSERT_EQ(hit.load(), 1);
+}